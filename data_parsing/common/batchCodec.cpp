@@ -0,0 +1,362 @@
+#include "batchCodec.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+inline uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline size_t varintSize(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+inline unsigned char* putVarint(unsigned char* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(value);
+    return out;
+}
+
+inline bool getVarint(const unsigned char*& in, const unsigned char* end, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && in < end; shift += 7) {
+        unsigned char byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Wrapping arithmetic: deltas of extreme values overflow int64 and must
+// still round-trip.
+inline int64_t wrapSub(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+inline int64_t wrapAdd(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+bool quantizeSpeed(double speed, int64_t& quantized) {
+    double scaled = speed * kSpeedScale;
+    if (!(std::fabs(scaled) < 9.0e15)) {  // also rejects NaN
+        return false;
+    }
+    quantized = std::llround(scaled);
+    return static_cast<double>(quantized) / kSpeedScale == speed;
+}
+
+inline int64_t timestampTerm(const std::vector<WireRecord>& records, size_t i, int64_t timestampNs) {
+    if (i == 0) {
+        return timestampNs;
+    }
+    int64_t delta = wrapSub(timestampNs, records[i - 1].timestampNs);
+    if (i == 1) {
+        return delta;
+    }
+    return wrapSub(delta, wrapSub(records[i - 1].timestampNs, records[i - 2].timestampNs));
+}
+
+bool decodeFixed(const unsigned char* in, size_t len, std::vector<WireRecord>& records) {
+    uint16_t count = 0;
+    if ((in[1] & ~(kBatchFlagQueuedTime | kBatchFlagPriority)) != 0 || !decodeBatchHeader(in, len, count)) {
+        return false;
+    }
+    records.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (!decodeRecord(in + kBatchHeaderSize + i * kWireRecordSize, kWireRecordSize, records[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decodeDelta(const unsigned char* in, size_t len, std::vector<WireRecord>& records) {
+    constexpr uint8_t kKnownFlags = kDeltaFlagQuantizedSpeed | kBatchFlagQueuedTime | kBatchFlagPriority;
+    if (len < kBatchHeaderSize || (in[1] & ~kKnownFlags) != 0) {
+        return false;
+    }
+    const size_t count = static_cast<size_t>(in[2] | (in[3] << 8));
+    const bool quantized = (in[1] & kDeltaFlagQuantizedSpeed) != 0;
+    const unsigned char* cursor = in + kBatchHeaderSize;
+    const unsigned char* end = in + len;
+    records.resize(count);
+    uint64_t raw = 0;
+
+    int64_t id = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!getVarint(cursor, end, raw)) {
+            return false;
+        }
+        id = wrapAdd(id, unzigzag(raw));
+        if (id < INT32_MIN || id > INT32_MAX) {
+            return false;
+        }
+        records[i].vehicleId = static_cast<int32_t>(id);
+    }
+
+    int64_t timestamp = 0;
+    int64_t delta = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!getVarint(cursor, end, raw)) {
+            return false;
+        }
+        int64_t term = unzigzag(raw);
+        if (i == 0) {
+            timestamp = term;
+        } else {
+            delta = i == 1 ? term : wrapAdd(delta, term);
+            timestamp = wrapAdd(timestamp, delta);
+        }
+        records[i].timestampNs = timestamp;
+    }
+
+    if (quantized) {
+        int64_t q = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!getVarint(cursor, end, raw)) {
+                return false;
+            }
+            q = wrapAdd(q, unzigzag(raw));
+            records[i].speed = static_cast<double>(q) / kSpeedScale;
+        }
+    } else {
+        if (static_cast<size_t>(end - cursor) < count * 8) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i, cursor += 8) {
+            uint64_t bits = 0;
+            for (int b = 7; b >= 0; --b) {
+                bits = (bits << 8) | cursor[b];
+            }
+            std::memcpy(&records[i].speed, &bits, sizeof(bits));
+        }
+    }
+
+    const size_t bitmapBytes = (count + 7) / 8;
+    if (static_cast<size_t>(end - cursor) < bitmapBytes) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        records[i].engineOn = (cursor[i / 8] >> (i % 8)) & 1;
+    }
+    cursor += bitmapBytes;
+
+    size_t filled = 0;
+    while (filled < count) {
+        if (cursor >= end || *cursor > static_cast<unsigned char>(EngineStatus::E_Unknown)) {
+            return false;
+        }
+        auto status = static_cast<EngineStatus>(*cursor++);
+        if (!getVarint(cursor, end, raw) || raw == 0 || raw > count - filled) {
+            return false;
+        }
+        for (size_t n = 0; n < raw; ++n) {
+            records[filled++].status = status;
+        }
+    }
+    return cursor == end;
+}
+
+}  // namespace
+
+const char* batchEncodingToString(BatchEncoding encoding) {
+    switch (encoding) {
+        case BatchEncoding::Fixed: return "fixed";
+        case BatchEncoding::Delta: return "delta";
+    }
+    return "unknown";
+}
+
+bool parseBatchEncoding(std::string_view name, BatchEncoding& encoding) {
+    if (name == "fixed") {
+        encoding = BatchEncoding::Fixed;
+    } else if (name == "delta") {
+        encoding = BatchEncoding::Delta;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool batchEncodingFromArgs(int argc, char** argv, BatchEncoding& encoding) {
+    constexpr std::string_view kPrefix = "--encoding=";
+    encoding = BatchEncoding::Delta;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, kPrefix.size()) == kPrefix && !parseBatchEncoding(arg.substr(kPrefix.size()), encoding)) {
+            std::cerr << "Unknown batch encoding: " << arg.substr(kPrefix.size()) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void DeltaBatchEncoder::reset() {
+    records_.clear();
+    sizes_ = Sizes{};
+    lastQuantized_ = 0;
+}
+
+DeltaBatchEncoder::Sizes DeltaBatchEncoder::sizesWith(const WireRecord& record) const {
+    Sizes sizes = sizes_;
+    const size_t i = records_.size();
+    const int64_t previousId = i == 0 ? 0 : records_[i - 1].vehicleId;
+    sizes.idBytes += varintSize(zigzag(wrapSub(record.vehicleId, previousId)));
+    sizes.timestampBytes += varintSize(zigzag(timestampTerm(records_, i, record.timestampNs)));
+
+    int64_t quantized = 0;
+    if (sizes.quantized && quantizeSpeed(record.speed, quantized)) {
+        sizes.quantizedSpeedBytes += varintSize(zigzag(wrapSub(quantized, lastQuantized_)));
+    } else {
+        sizes.quantized = false;
+    }
+
+    if (i > 0 && records_[i - 1].status == record.status) {
+        ++sizes.openRun;
+    } else {
+        if (i > 0) {
+            sizes.closedRunBytes += 1 + varintSize(sizes.openRun);
+        }
+        sizes.openRun = 1;
+    }
+    return sizes;
+}
+
+size_t DeltaBatchEncoder::totalSize(const Sizes& sizes, size_t count) const {
+    if (count == 0) {
+        return 0;
+    }
+    size_t speedBytes = sizes.quantized ? sizes.quantizedSpeedBytes : count * 8;
+    return kBatchHeaderSize + sizes.idBytes + sizes.timestampBytes + speedBytes + (count + 7) / 8 +
+           sizes.closedRunBytes + 1 + varintSize(sizes.openRun);
+}
+
+size_t DeltaBatchEncoder::sizeWith(const WireRecord& record) const {
+    return totalSize(sizesWith(record), records_.size() + 1);
+}
+
+size_t DeltaBatchEncoder::encodedSize() const {
+    return totalSize(sizes_, records_.size());
+}
+
+void DeltaBatchEncoder::add(const WireRecord& record) {
+    sizes_ = sizesWith(record);
+    int64_t quantized = 0;
+    if (sizes_.quantized && quantizeSpeed(record.speed, quantized)) {
+        lastQuantized_ = quantized;
+    }
+    records_.push_back(record);
+}
+
+size_t DeltaBatchEncoder::finish(unsigned char* out, size_t cap) const {
+    const size_t count = records_.size();
+    const size_t size = encodedSize();
+    if (count == 0 || count > UINT16_MAX || cap < size) {
+        return 0;
+    }
+    out[0] = kDeltaBatchVersion;
+    out[1] = sizes_.quantized ? kDeltaFlagQuantizedSpeed : 0;
+    out[2] = static_cast<unsigned char>(count & 0xff);
+    out[3] = static_cast<unsigned char>(count >> 8);
+    unsigned char* cursor = out + kBatchHeaderSize;
+
+    int64_t previousId = 0;
+    for (const WireRecord& record : records_) {
+        cursor = putVarint(cursor, zigzag(wrapSub(record.vehicleId, previousId)));
+        previousId = record.vehicleId;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        cursor = putVarint(cursor, zigzag(timestampTerm(records_, i, records_[i].timestampNs)));
+    }
+    if (sizes_.quantized) {
+        int64_t previous = 0;
+        for (const WireRecord& record : records_) {
+            int64_t quantized = 0;
+            quantizeSpeed(record.speed, quantized);
+            cursor = putVarint(cursor, zigzag(wrapSub(quantized, previous)));
+            previous = quantized;
+        }
+    } else {
+        for (const WireRecord& record : records_) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &record.speed, sizeof(bits));
+            for (int b = 0; b < 8; ++b, bits >>= 8) {
+                *cursor++ = static_cast<unsigned char>(bits);
+            }
+        }
+    }
+    std::memset(cursor, 0, (count + 7) / 8);
+    for (size_t i = 0; i < count; ++i) {
+        cursor[i / 8] |= static_cast<unsigned char>(records_[i].engineOn ? 1u << (i % 8) : 0);
+    }
+    cursor += (count + 7) / 8;
+    for (size_t i = 0; i < count;) {
+        size_t run = 1;
+        while (i + run < count && records_[i + run].status == records_[i].status) {
+            ++run;
+        }
+        *cursor++ = static_cast<unsigned char>(records_[i].status);
+        cursor = putVarint(cursor, run);
+        i += run;
+    }
+    return static_cast<size_t>(cursor - out);
+}
+
+size_t appendBatchTrailer(unsigned char* payload, size_t len, size_t cap, int64_t queuedNs, bool priority) {
+    if (len < kBatchHeaderSize || cap < len + kBatchTrailerSize) {
+        return 0;
+    }
+    payload[1] |= kBatchFlagQueuedTime | (priority ? kBatchFlagPriority : 0);
+    uint64_t bits = static_cast<uint64_t>(queuedNs);
+    for (size_t b = 0; b < kBatchTrailerSize; ++b, bits >>= 8) {
+        payload[len + b] = static_cast<unsigned char>(bits);
+    }
+    return len + kBatchTrailerSize;
+}
+
+bool decodeBatch(const unsigned char* in, size_t len, std::vector<WireRecord>& records, BatchInfo* info) {
+    if (len < kBatchHeaderSize) {
+        return false;
+    }
+    BatchInfo parsed;
+    parsed.priority = (in[1] & kBatchFlagPriority) != 0;
+    if ((in[1] & kBatchFlagQueuedTime) != 0) {
+        if (len < kBatchHeaderSize + kBatchTrailerSize) {
+            return false;
+        }
+        len -= kBatchTrailerSize;
+        uint64_t bits = 0;
+        for (size_t b = kBatchTrailerSize; b-- > 0;) {
+            bits = (bits << 8) | in[len + b];
+        }
+        parsed.hasQueuedTime = true;
+        parsed.queuedNs = static_cast<int64_t>(bits);
+    }
+    if (info != nullptr) {
+        *info = parsed;
+    }
+    if (in[0] == kBatchVersion) {
+        return decodeFixed(in, len, records);
+    }
+    if (in[0] == kDeltaBatchVersion) {
+        return decodeDelta(in, len, records);
+    }
+    return false;
+}
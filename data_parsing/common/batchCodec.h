@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "vehicleWire.h"
+
+// How the sender lays out a record batch. Fixed is the version 1 layout
+// (header + 24-byte records); Delta is the column-wise compressed version 2
+// layout below. The receiver accepts either, keyed on the version byte.
+enum class BatchEncoding : uint8_t {
+    Fixed = 0,
+    Delta,
+};
+
+const char* batchEncodingToString(BatchEncoding encoding);
+bool parseBatchEncoding(std::string_view name, BatchEncoding& encoding);
+// Reads --encoding=fixed|delta; defaults to Delta. Returns false on an unknown name.
+bool batchEncodingFromArgs(int argc, char** argv, BatchEncoding& encoding);
+
+// Version 2 batch: the usual 4-byte header ([1] carries flags) followed by
+// one section per field, each covering all `count` records:
+//   ids        zigzag varint of the delta to the previous id
+//   timestamps zigzag varint: first value, first delta, then delta-of-delta
+//   speeds     flag set: zigzag varint delta of speed * 1000 (fixed point)
+//              flag clear: raw little-endian doubles
+//   engine     bitmap, record i in bit i % 8 of byte i / 8
+//   status     runs of [status byte][varint run length]
+// Speeds are only quantized when every speed in the batch survives the
+// round trip exactly, so the codec is lossless.
+constexpr uint8_t kDeltaBatchVersion = 2;
+constexpr uint8_t kDeltaFlagQuantizedSpeed = 0x01;
+constexpr int64_t kSpeedScale = 1000;
+
+// Builds one version 2 batch. The encoded size is tracked exactly as records
+// are added, so the caller can stop right before a message limit.
+class DeltaBatchEncoder {
+public:
+    void reset();
+    // Encoded size of the batch if record were appended next.
+    size_t sizeWith(const WireRecord& record) const;
+    void add(const WireRecord& record);
+
+    size_t count() const { return records_.size(); }
+    size_t encodedSize() const;
+    // Writes the batch into out; returns bytes written, or 0 if cap is too
+    // small or the batch is empty.
+    size_t finish(unsigned char* out, size_t cap) const;
+
+private:
+    struct Sizes {
+        size_t idBytes = 0;
+        size_t timestampBytes = 0;
+        size_t quantizedSpeedBytes = 0;
+        bool quantized = true;
+        size_t closedRunBytes = 0;
+        uint64_t openRun = 0;
+    };
+    Sizes sizesWith(const WireRecord& record) const;
+    size_t totalSize(const Sizes& sizes, size_t count) const;
+
+    std::vector<WireRecord> records_;
+    Sizes sizes_;
+    int64_t lastQuantized_ = 0;
+};
+
+// Optional 8-byte trailer, valid on either version and flagged in header
+// byte [1]: the sender's CLOCK_MONOTONIC time (ns) when the oldest record in
+// the batch was queued, for end-to-end latency on the same host. Priority
+// marks a batch of fault records sent ahead of routine traffic.
+constexpr uint8_t kBatchFlagQueuedTime = 0x40;
+constexpr uint8_t kBatchFlagPriority = 0x80;
+constexpr size_t kBatchTrailerSize = 8;
+
+// Sets the flags in payload's header and appends the trailer after len bytes.
+// Returns the new length, or 0 if cap is too small.
+size_t appendBatchTrailer(unsigned char* payload, size_t len, size_t cap, int64_t queuedNs, bool priority);
+
+struct BatchInfo {
+    bool hasQueuedTime = false;
+    int64_t queuedNs = 0;
+    bool priority = false;
+};
+
+// Decodes a version 1 or version 2 batch into records (replacing its
+// contents), and its trailer into info if given. Bounds-checked: any
+// truncation, trailing bytes or bad field value rejects the whole message.
+bool decodeBatch(const unsigned char* in, size_t len, std::vector<WireRecord>& records, BatchInfo* info = nullptr);
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "batchCodec.h"
+#include "timestamp.h"
+
+namespace {
+
+bool sameRecords(const std::vector<WireRecord>& a, const std::vector<WireRecord>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].vehicleId != b[i].vehicleId || a[i].timestampNs != b[i].timestampNs ||
+            std::memcmp(&a[i].speed, &b[i].speed, sizeof(double)) != 0 || a[i].engineOn != b[i].engineOn ||
+            a[i].status != b[i].status) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Encodes records, checks the predicted size and decodes them back.
+size_t roundTrip(const std::vector<WireRecord>& records) {
+    DeltaBatchEncoder encoder;
+    for (const auto& r : records) {
+        size_t predicted = encoder.sizeWith(r);
+        encoder.add(r);
+        assert(encoder.encodedSize() == predicted);
+    }
+    std::vector<unsigned char> buf(encoder.encodedSize());
+    assert(encoder.finish(buf.data(), buf.size() - 1) == 0);
+    size_t len = encoder.finish(buf.data(), buf.size());
+    assert(len == buf.size());
+    std::vector<WireRecord> decoded;
+    assert(decodeBatch(buf.data(), len, decoded));
+    assert(sameRecords(records, decoded));
+    return len;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "[Test] starting batch codec tests\n";
+
+    // Test 1: a typical feed (rising ids and timestamps, one-decimal speeds,
+    // mostly ENGINE_OK) shrinks at least 4x against the fixed layout.
+    {
+        std::mt19937 rng(1);
+        std::vector<WireRecord> records;
+        int64_t ts = 1771064123LL * kNanosPerSecond;
+        double speed = 80.0;
+        for (int i = 0; i < 1000; ++i) {
+            ts += kNanosPerSecond + (rng() % 3 == 0 ? 1000 : 0);
+            speed = std::round((speed + (static_cast<int>(rng() % 21) - 10) / 10.0) * 10.0) / 10.0;
+            EngineStatus status = rng() % 50 == 0 ? EngineStatus::E_Overheat : EngineStatus::OK;
+            records.push_back(WireRecord{1000 + i, ts, speed, rng() % 10 != 0, status});
+        }
+        size_t len = roundTrip(records);
+        size_t fixed = kBatchHeaderSize + records.size() * kWireRecordSize;
+        std::cout << "[Test1] " << fixed << " -> " << len << " bytes\n";
+        assert(len * 4 <= fixed);
+    }
+
+    // Test 2: extreme values and speeds that cannot be quantized stay exact.
+    {
+        std::vector<WireRecord> records = {
+            {INT32_MIN, INT64_MIN, -0.0, true, EngineStatus::E_Unknown},
+            {INT32_MAX, INT64_MAX, 1e300, false, EngineStatus::OK},
+            {0, 0, std::numeric_limits<double>::quiet_NaN(), true, EngineStatus::E_SensorFailure},
+            {-5, -1, 0.1 + 0.2, false, EngineStatus::E_SensorFailure},
+        };
+        roundTrip(records);
+        roundTrip({records[1]});
+        std::mt19937_64 rng(2);
+        std::vector<WireRecord> noisy;
+        for (int i = 0; i < 5000; ++i) {
+            double speed;
+            uint64_t bits = rng();
+            std::memcpy(&speed, &bits, sizeof(speed));
+            noisy.push_back(WireRecord{static_cast<int32_t>(rng()), static_cast<int64_t>(rng()), speed,
+                                       (rng() & 1) != 0, static_cast<EngineStatus>(rng() % 5)});
+        }
+        roundTrip(noisy);
+        std::cout << "[Test2] extreme values ok\n";
+    }
+
+    // Test 3: truncated, padded or corrupted batches are rejected, and
+    // version 1 batches still decode.
+    {
+        std::vector<WireRecord> records;
+        for (int i = 0; i < 20; ++i) {
+            records.push_back(WireRecord{i, i * kNanosPerSecond, i * 1.5, i % 2 == 0, EngineStatus::OK});
+        }
+        DeltaBatchEncoder encoder;
+        for (const auto& r : records) { encoder.add(r); }
+        std::vector<unsigned char> buf(encoder.encodedSize() + 1);
+        size_t len = encoder.finish(buf.data(), buf.size());
+        std::vector<WireRecord> decoded;
+        for (size_t cut = 0; cut < len; ++cut) {
+            assert(!decodeBatch(buf.data(), cut, decoded));
+        }
+        assert(!decodeBatch(buf.data(), len + 1, decoded));
+        buf[len - 2] = 7;  // status byte of the only run
+        assert(!decodeBatch(buf.data(), len, decoded));
+
+        std::vector<unsigned char> fixed(kBatchHeaderSize + 2 * kWireRecordSize);
+        encodeBatchHeader(2, fixed.data());
+        encodeRecord(records[3], fixed.data() + kBatchHeaderSize, kWireRecordSize);
+        encodeRecord(records[4], fixed.data() + kBatchHeaderSize + kWireRecordSize, kWireRecordSize);
+        assert(decodeBatch(fixed.data(), fixed.size(), decoded));
+        assert(sameRecords(decoded, {records[3], records[4]}));
+        std::cout << "[Test3] malformed input rejected, v1 ok\n";
+    }
+
+    // Test 4: the queued-time trailer and priority flag round-trip on both
+    // versions and do not disturb the records.
+    {
+        std::vector<WireRecord> records = {{7, 1, 2.5, true, EngineStatus::E_Overheat}};
+        DeltaBatchEncoder encoder;
+        encoder.add(records[0]);
+        std::vector<unsigned char> buf(encoder.encodedSize() + kBatchTrailerSize);
+        size_t len = encoder.finish(buf.data(), buf.size());
+        assert(appendBatchTrailer(buf.data(), len, len + kBatchTrailerSize - 1, 1, false) == 0);
+        len = appendBatchTrailer(buf.data(), len, buf.size(), -123456789, true);
+        assert(len == buf.size());
+        std::vector<WireRecord> decoded;
+        BatchInfo info;
+        assert(decodeBatch(buf.data(), len, decoded, &info));
+        assert(info.hasQueuedTime && info.queuedNs == -123456789 && info.priority && sameRecords(decoded, records));
+        assert(!decodeBatch(buf.data(), len - 1, decoded));
+
+        std::vector<unsigned char> fixed(kBatchHeaderSize + kWireRecordSize + kBatchTrailerSize);
+        encodeBatchHeader(1, fixed.data());
+        encodeRecord(records[0], fixed.data() + kBatchHeaderSize, kWireRecordSize);
+        len = appendBatchTrailer(fixed.data(), kBatchHeaderSize + kWireRecordSize, fixed.size(), 42, false);
+        assert(decodeBatch(fixed.data(), len, decoded, &info));
+        assert(info.hasQueuedTime && info.queuedNs == 42 && !info.priority && sameRecords(decoded, records));
+        std::cout << "[Test4] trailer ok\n";
+    }
+
+    std::cout << "[Test] all batch codec tests passed\n";
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "orderedRun.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+size_t orderedRunWorkers(const OrderedRunOptions& options) {
+    return static_cast<size_t>(std::min<uint64_t>(std::max<size_t>(options.workers, 1), options.count));
+}
+
+size_t orderedRunWindow(const OrderedRunOptions& options) {
+    return static_cast<size_t>(std::min<uint64_t>(std::max<size_t>(options.window, 1), options.count));
+}
+
+bool runInOrder(const OrderedRunOptions& options, const OrderedProduce& produce, const OrderedConsume& consume) {
+    if (options.count == 0) {
+        return true;
+    }
+    const uint64_t count = options.count;
+    const size_t workers = orderedRunWorkers(options);
+    const size_t window = orderedRunWindow(options);
+
+    std::vector<char> ready(window, 0);
+    std::mutex mutex;
+    std::condition_variable slotReadyCv;
+    std::condition_variable slotFreeCv;
+    std::atomic<uint64_t> nextIndex{0};
+    uint64_t consumed = 0;
+    bool stop = false;
+
+    auto workerLoop = [&](size_t worker) {
+        while (true) {
+            const uint64_t index = nextIndex.fetch_add(1);
+            if (index >= count) {
+                return;
+            }
+            const size_t slot = static_cast<size_t>(index % window);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotFreeCv.wait(lock, [&] { return stop || index < consumed + window; });
+                if (stop) {
+                    return;
+                }
+            }
+            produce(worker, index, slot);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready[slot] = 1;
+            }
+            slotReadyCv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads.emplace_back(workerLoop, i);
+    }
+
+    bool completed = true;
+    for (uint64_t index = 0; index < count; ++index) {
+        const size_t slot = static_cast<size_t>(index % window);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotReadyCv.wait(lock, [&] { return ready[slot] != 0; });
+        }
+        const bool keepGoing = consume(index, slot);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[slot] = 0;
+            ++consumed;
+            stop = !keepGoing;
+        }
+        slotFreeCv.notify_all();
+        if (!keepGoing) {
+            completed = false;
+            break;
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return completed;
+}
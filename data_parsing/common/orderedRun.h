@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+struct OrderedRunOptions {
+    uint64_t count = 0;  // items; UINT64_MAX for a run that consume() ends
+    size_t workers = 1;  // threads; clamped to [1, count]
+    size_t window = 2;   // slots; clamped to [1, count]
+};
+
+using OrderedProduce = std::function<void(size_t worker, uint64_t index, size_t slot)>;
+using OrderedConsume = std::function<bool(uint64_t index, size_t slot)>;
+
+// Worker and slot counts a run with these options uses, so callers can size
+// per-worker state and slot buffers up front.
+size_t orderedRunWorkers(const OrderedRunOptions& options);
+size_t orderedRunWindow(const OrderedRunOptions& options);
+
+// Produces items [0, count) on a pool of threads and consumes them on the
+// calling thread strictly in index order. Each item in flight owns one of the
+// window slots: produce(worker, index, slot) fills the caller's buffer for
+// that slot, consume(index, slot) reads it after every earlier item. A worker
+// waits until its slot is free, so at most `window` items exist at once.
+// worker is in [0, workers) and fixed per thread, for per-thread state.
+// consume returns false to stop; workers then exit after the item in hand.
+// Returns false if consume stopped the run.
+bool runInOrder(const OrderedRunOptions& options, const OrderedProduce& produce, const OrderedConsume& consume);
@@ -0,0 +1,68 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "orderedRun.h"
+
+int main() {
+    std::cout << "[Test] starting ordered run tests\n";
+
+    // Test 1: every item is consumed once, in order, from the slot it was produced into.
+    for (size_t workers : {1, 3, 8}) {
+        for (size_t window : {1, 2, 16}) {
+            const OrderedRunOptions options{1000, workers, window};
+            std::vector<uint64_t> slots(orderedRunWindow(options));
+            std::vector<uint64_t> produced(orderedRunWorkers(options), 0);
+            uint64_t next = 0;
+            bool ok = runInOrder(
+                options,
+                [&](size_t worker, uint64_t index, size_t slot) {
+                    assert(worker < produced.size());
+                    ++produced[worker];
+                    slots[slot] = index * index;
+                },
+                [&](uint64_t index, size_t slot) {
+                    assert(index == next && slots[slot] == index * index);
+                    ++next;
+                    return true;
+                });
+            assert(ok && next == 1000);
+            uint64_t total = 0;
+            for (uint64_t n : produced) {
+                total += n;
+            }
+            assert(total == 1000);
+        }
+    }
+    std::cout << "[Test1] in-order consumption ok\n";
+
+    // Test 2: an open-ended run stops when consume says so, without hanging the workers.
+    {
+        const OrderedRunOptions options{UINT64_MAX, 4, 8};
+        std::vector<uint64_t> slots(orderedRunWindow(options));
+        uint64_t consumed = 0;
+        bool ok = runInOrder(
+            options, [&](size_t, uint64_t index, size_t slot) { slots[slot] = index; },
+            [&](uint64_t index, size_t slot) {
+                assert(slots[slot] == index);
+                return ++consumed < 50;
+            });
+        assert(!ok && consumed == 50);
+        std::cout << "[Test2] early stop ok\n";
+    }
+
+    // Test 3: counts clamp to the number of items, and an empty run does nothing.
+    {
+        const OrderedRunOptions small{3, 8, 16};
+        assert(orderedRunWorkers(small) == 3 && orderedRunWindow(small) == 3);
+        bool called = false;
+        assert(runInOrder(
+            OrderedRunOptions{0, 4, 4}, [&](size_t, uint64_t, size_t) { called = true; },
+            [&](uint64_t, size_t) { return called = true; }));
+        assert(!called);
+        std::cout << "[Test3] clamping ok\n";
+    }
+
+    std::cout << "\n[Test] all ordered run tests passed\n";
+    return 0;
+}
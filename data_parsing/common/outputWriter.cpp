@@ -0,0 +1,230 @@
+#include "outputWriter.h"
+#include "timestamp.h"
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <unistd.h>
+
+namespace {
+
+void appendInt(std::string& out, int64_t value) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+// Shortest representation that round-trips, for machine-readable formats.
+void appendDouble(std::string& out, double value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+}  // namespace
+
+void appendFixed(std::string& out, double value, int precision) {
+    // Holds the largest finite double, so a valid but huge value is never cut short.
+    char buf[std::numeric_limits<double>::max_exponent10 + 32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+    out.append(buf, result.ptr);
+}
+
+bool outputOptionsFromArgs(int argc, char** argv, OutputOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg == "--async-output") {
+            options.background = true;
+        } else if (arg == "-q") {
+            options.verbosity = Verbosity::Quiet;
+        } else if (arg == "-v") {
+            options.verbosity = Verbosity::Verbose;
+        } else if (arg.substr(0, 9) == "--format=") {
+            std::string_view value = arg.substr(9);
+            if (value == "human") {
+                options.format = OutputFormat::Human;
+            } else if (value == "csv") {
+                options.format = OutputFormat::Csv;
+            } else if (value == "json") {
+                options.format = OutputFormat::JsonLines;
+            } else {
+                std::cerr << "Unknown output format: " << value << std::endl;
+                return false;
+            }
+        } else if (arg.substr(0, 12) == "--verbosity=") {
+            std::string_view value = arg.substr(12);
+            if (value == "quiet") {
+                options.verbosity = Verbosity::Quiet;
+            } else if (value == "normal") {
+                options.verbosity = Verbosity::Normal;
+            } else if (value == "verbose") {
+                options.verbosity = Verbosity::Verbose;
+            } else {
+                std::cerr << "Unknown verbosity: " << value << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+OutputWriter::OutputWriter(int fd, const OutputOptions& options) : fd_(fd), options_(options) {
+    active_.reserve(options_.bufferBytes);
+    if (options_.background) {
+        pending_.reserve(options_.bufferBytes);
+        writer_ = std::thread(&OutputWriter::writerLoop, this);
+    }
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+    }
+}
+
+void OutputWriter::append(std::string_view text) {
+    if (active_.empty()) {
+        oldest_ = Clock::now();
+    }
+    active_.append(text);
+    noteAppended();
+}
+
+void OutputWriter::appendRecord(const WireRecord& record) {
+    if (active_.empty()) {
+        oldest_ = Clock::now();
+    }
+    char time[kTimestampTextLen + 1];
+    formatTimestamp(record.timestampNs, time);
+    const char* engine = record.engineOn ? "ON" : "OFF";
+    const int status = static_cast<int>(record.status);
+
+    switch (options_.format) {
+        case OutputFormat::Human: {
+            active_ += "Field: ID:";
+            appendInt(active_, record.vehicleId);
+            active_ += "\nField: Time:";
+            active_.append(time, kTimestampTextLen);
+            active_ += "\nField: Speed:";
+            appendFixed(active_, record.speed, 2);
+            active_ += "\nField: Engine:";
+            active_ += engine;
+            active_ += "\nField: ErrorCode:";
+            appendInt(active_, status);
+            active_ += '\n';
+            break;
+        }
+        case OutputFormat::Csv:
+            if (!csvHeaderWritten_) {
+                active_ += "vehicleId,timestamp,speed,engine,errorCode\n";
+                csvHeaderWritten_ = true;
+            }
+            appendInt(active_, record.vehicleId);
+            active_ += ',';
+            active_.append(time, kTimestampTextLen);
+            active_ += ',';
+            appendDouble(active_, record.speed);
+            active_ += ',';
+            active_ += engine;
+            active_ += ',';
+            appendInt(active_, status);
+            active_ += '\n';
+            break;
+        case OutputFormat::JsonLines:
+            active_ += "{\"vehicleId\":";
+            appendInt(active_, record.vehicleId);
+            active_ += ",\"timestamp\":\"";
+            active_.append(time, kTimestampTextLen);
+            active_ += "\",\"timestampNs\":";
+            appendInt(active_, record.timestampNs);
+            active_ += ",\"speed\":";
+            appendDouble(active_, record.speed);
+            active_ += ",\"engine\":\"";
+            active_ += engine;
+            active_ += "\",\"errorCode\":";
+            appendInt(active_, status);
+            active_ += "}\n";
+            break;
+    }
+    noteAppended();
+}
+
+void OutputWriter::noteAppended() {
+    if (active_.size() >= options_.bufferBytes) {
+        handOff();
+    } else {
+        flushIfDue();
+    }
+}
+
+void OutputWriter::flushIfDue() {
+    if (!active_.empty() && Clock::now() - oldest_ >= options_.flushInterval) {
+        handOff();
+    }
+}
+
+void OutputWriter::flush() {
+    handOff();
+    if (writer_.joinable()) {
+        // Wait until the writer thread has put everything on the fd.
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return pending_.empty(); });
+    }
+}
+
+void OutputWriter::handOff() {
+    if (active_.empty()) {
+        return;
+    }
+    if (!writer_.joinable()) {
+        writeAll(active_);
+        active_.clear();
+        return;
+    }
+    {
+        // Only blocks if the writer thread is still busy with the previous buffer.
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return pending_.empty(); });
+        pending_.swap(active_);
+    }
+    cv_.notify_all();
+}
+
+void OutputWriter::writeAll(const std::string& data) {
+    const char* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd_, cursor, remaining);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            return;
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+void OutputWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;  // stop requested and nothing left
+        }
+        lock.unlock();
+        writeAll(pending_);
+        lock.lock();
+        pending_.clear();
+        cv_.notify_all();
+    }
+}
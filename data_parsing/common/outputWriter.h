@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "vehicleWire.h"
+
+enum class OutputFormat : uint8_t {
+    Human = 0,  // one "Field: ..." line per field
+    Csv,
+    JsonLines,
+};
+
+enum class Verbosity : uint8_t {
+    Quiet = 0,  // end-of-run summaries only
+    Normal,     // plus per-batch progress (receiver: records)
+    Verbose,    // plus per-record logging on the sender
+};
+
+struct OutputOptions {
+    OutputFormat format = OutputFormat::Human;
+    Verbosity verbosity = Verbosity::Normal;
+    bool background = false;  // hand full buffers to a writer thread
+    size_t bufferBytes = 1 << 20;
+    std::chrono::milliseconds flushInterval{100};
+};
+
+// Reads --format=human|csv|json, --verbosity=quiet|normal|verbose (or -q / -v)
+// and --async-output. Returns false on an unknown value.
+bool outputOptionsFromArgs(int argc, char** argv, OutputOptions& options);
+
+// Appends value in fixed notation, as printf's "%.<precision>f" writes it.
+void appendFixed(std::string& out, double value, int precision);
+
+// Buffered writer for a file descriptor. Text accumulates in a large buffer
+// that is written out when it fills, when the oldest byte is older than the
+// flush interval (checked on append and by flushIfDue()), or on flush().
+// With background output the write(2) happens on a helper thread while the
+// caller keeps filling a second buffer.
+class OutputWriter {
+public:
+    OutputWriter(int fd, const OutputOptions& options);
+    ~OutputWriter();
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    bool enabled(Verbosity level) const { return options_.verbosity >= level; }
+    const OutputOptions& options() const { return options_; }
+
+    void append(std::string_view text);
+    // Renders one record in the configured format (CSV gets a header first).
+    void appendRecord(const WireRecord& record);
+
+    void flushIfDue();
+    void flush();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void noteAppended();
+    void handOff();
+    void writeAll(const std::string& data);
+    void writerLoop();
+
+    int fd_;
+    OutputOptions options_;
+    std::string active_;
+    Clock::time_point oldest_{};
+    bool csvHeaderWritten_ = false;
+
+    // Background mode only.
+    std::string pending_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread writer_;
+};
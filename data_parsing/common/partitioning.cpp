@@ -0,0 +1,37 @@
+#include "partitioning.h"
+#include <charconv>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+// Finds "<prefix><number>" and range-checks it; leaves value alone if absent.
+bool numberArg(int argc, char** argv, std::string_view prefix, uint32_t min, uint32_t max, uint32_t& value) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, prefix.size()) != prefix) {
+            continue;
+        }
+        std::string_view text = arg.substr(prefix.size());
+        uint32_t parsed = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (result.ec != std::errc() || result.ptr != text.data() + text.size() || parsed < min || parsed > max) {
+            std::cerr << "Invalid " << prefix << text << " (expected " << min << ".." << max << ")" << std::endl;
+            return false;
+        }
+        value = parsed;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool partitionCountFromArgs(int argc, char** argv, uint32_t& partitions) {
+    partitions = 1;
+    return numberArg(argc, argv, "--partitions=", 1, kMaxPartitions, partitions);
+}
+
+bool partitionIndexFromArgs(int argc, char** argv, uint32_t& partition) {
+    partition = 0;
+    return numberArg(argc, argv, "--partition=", 0, kMaxPartitions - 1, partition);
+}
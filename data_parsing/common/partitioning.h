@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Upper bound on --partitions; also keeps SysV mtypes small.
+constexpr uint32_t kMaxPartitions = 64;
+
+// Jump consistent hash (Lamping & Veach): maps a vehicle to one of
+// `partitions` buckets with no lookup table, and when the count changes
+// from n to n+1 only ~1/(n+1) of the vehicles move. Every record of a
+// vehicle lands in the same partition, which keeps its order.
+inline uint32_t partitionForVehicle(int32_t vehicleId, uint32_t partitions) {
+    uint64_t key = static_cast<uint32_t>(vehicleId);
+    int64_t bucket = -1;
+    int64_t next = 0;
+    while (next < static_cast<int64_t>(partitions)) {
+        bucket = next;
+        key = key * 2862933555777941757ULL + 1;
+        next = static_cast<int64_t>((bucket + 1) * (static_cast<double>(1LL << 31) /
+                                                    static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<uint32_t>(bucket);
+}
+
+// Sender: "--partitions=N" (default 1). Receiver: "--partition=I" (default 0).
+// Both return false on a value outside [1, kMaxPartitions] / [0, kMaxPartitions).
+bool partitionCountFromArgs(int argc, char** argv, uint32_t& partitions);
+bool partitionIndexFromArgs(int argc, char** argv, uint32_t& partition);
@@ -0,0 +1,39 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "partitioning.h"
+
+int main() {
+    std::cout << "[Test] starting partitioning tests\n";
+
+    // Test 1: every id lands in range and the spread is roughly even.
+    for (uint32_t partitions : {1u, 2u, 7u, 16u, kMaxPartitions}) {
+        std::vector<size_t> counts(partitions, 0);
+        const int ids = 100000;
+        for (int id = 0; id < ids; ++id) {
+            uint32_t p = partitionForVehicle(1000 + id, partitions);
+            assert(p < partitions);
+            ++counts[p];
+        }
+        for (size_t c : counts) {
+            assert(c > ids / partitions * 8 / 10 && c < ids / partitions * 12 / 10);
+        }
+    }
+    std::cout << "[Test1] balanced\n";
+
+    // Test 2: growing from n to n+1 partitions only moves ids into the new one.
+    for (uint32_t n = 1; n < kMaxPartitions; ++n) {
+        size_t moved = 0;
+        for (int id = -5000; id < 5000; ++id) {
+            uint32_t before = partitionForVehicle(id, n);
+            uint32_t after = partitionForVehicle(id, n + 1);
+            assert(after == before || after == n);
+            moved += after != before;
+        }
+        assert(moved < 10000 * 2 / (n + 1));
+    }
+    std::cout << "[Test2] consistent under resize\n";
+
+    std::cout << "[Test] all partitioning tests passed\n";
+    return 0;
+}
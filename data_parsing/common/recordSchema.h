@@ -0,0 +1,377 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "timestamp.h"
+
+// Compile-time description of a delimited text record. A schema lists the
+// fields in order, each as a member pointer, a name and a codec; the
+// RecordSchema built from it parses and encodes that record type with the
+// field loop unrolled at compile time and no per-field dispatch:
+//
+//   constexpr TokenEntry<FixKind> kFixTokens[] = {{"2D", FixKind::TwoD}, {"3D", FixKind::ThreeD}};
+//   constexpr auto kGpsSchema = makeRecordSchema<GpsFix, ','>(
+//       schemaField<&GpsFix::vehicleId>("vehicleId", IntCodec{}),
+//       schemaField<&GpsFix::latitude>("latitude", DecimalCodec{}),
+//       schemaField<&GpsFix::fix>("fix", tokenCodec(kFixTokens)));
+//
+// Codecs provide decode(text, value) -> bool, encode(value, out) -> end
+// pointer and a constexpr maxEncodedSize(). Decoding never allocates or throws.
+
+// Integer field in base 10; the whole field must be consumed.
+struct IntCodec {
+    template <typename T>
+    bool decode(std::string_view text, T& value) const {
+        static_assert(std::is_integral_v<T>, "IntCodec needs an integral member");
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+    template <typename T>
+    char* encode(T value, char* out) const {
+        return std::to_chars(out, out + maxEncodedSize(), value).ptr;
+    }
+    constexpr size_t maxEncodedSize() const { return 20; }
+};
+
+// Floating-point field; encodes the shortest text that parses back exactly.
+struct DecimalCodec {
+    template <typename T>
+    bool decode(std::string_view text, T& value) const {
+        static_assert(std::is_floating_point_v<T>, "DecimalCodec needs a floating-point member");
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+    template <typename T>
+    char* encode(T value, char* out) const {
+        return std::to_chars(out, out + maxEncodedSize(), value).ptr;
+    }
+    constexpr size_t maxEncodedSize() const { return 24; }
+};
+
+// "YYYY-MM-DD HH:MM:SS" (UTC) <-> int64_t epoch nanoseconds; see timestamp.h.
+struct TimestampCodec {
+    bool decode(std::string_view text, int64_t& value) const { return parseTimestamp(text, value); }
+    char* encode(int64_t value, char* out) const {
+        char text[kTimestampTextLen + 1];
+        size_t len = formatTimestamp(value, text);
+        std::memcpy(out, text, len);
+        return out + len;
+    }
+    constexpr size_t maxEncodedSize() const { return kTimestampTextLen; }
+};
+
+template <typename T>
+struct TokenEntry {
+    std::string_view token;
+    T value;
+};
+
+// n bytes of text from pos as a little-endian word. The byte loop is only
+// for compile time; at run time it is a single unaligned load.
+constexpr uint64_t tokenWord(std::string_view text, size_t pos, size_t n) {
+    if (!__builtin_is_constant_evaluated()) {
+        uint64_t word = 0;
+        std::memcpy(&word, text.data() + pos, n);
+        return word;
+    }
+    uint64_t word = 0;
+    for (size_t i = 0; i < n; ++i) {
+        word |= static_cast<uint64_t>(static_cast<uint8_t>(text[pos + i])) << (8 * i);
+    }
+    return word;
+}
+
+// A token's bytes packed into two words with fixed-size (overlapping) loads.
+// Together with the length this is exact for tokens of up to 16 bytes, so a
+// key compare replaces the string compare for them.
+struct TokenKey {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    size_t size = 0;
+
+    constexpr bool operator==(const TokenKey& other) const {
+        return head == other.head && tail == other.tail && size == other.size;
+    }
+};
+
+constexpr size_t kTokenKeyExactBytes = 16;
+
+constexpr TokenKey tokenKey(std::string_view text) {
+    const size_t size = text.size();
+    TokenKey key;
+    key.size = size;
+    if (size >= 8) {
+        key.head = tokenWord(text, 0, 8);
+        key.tail = tokenWord(text, size - 8, 8);
+    } else if (size >= 4) {
+        key.head = tokenWord(text, 0, 4) | (tokenWord(text, size - 4, 4) << 32);
+    } else if (size > 0) {
+        key.head = tokenWord(text, 0, 1) | (tokenWord(text, size / 2, 1) << 8) | (tokenWord(text, size - 1, 1) << 16);
+    }
+    return key;
+}
+
+// Fixed vocabulary of tokens mapped to values (several spellings may share a
+// value; the first one listed is the one encode() writes). Without a
+// fallback an unlisted token fails the field; with one it decodes to the
+// fallback value, which encodes as fallbackToken.
+//
+// Short tables are compared entry by entry in listing order, which for a
+// handful of tokens is as fast as any index (list the common spelling
+// first). From kIndexedFrom entries tokenCodec() also groups the tokens by
+// length at compile time, so decode is a switch on the field's length
+// followed by a key compare against the few tokens of that length (usually
+// one); new spellings only need adding to the table either way.
+template <typename T, size_t N>
+struct TokenCodec {
+    static_assert(N > 0 && N < 256, "token tables hold 1..255 entries");
+    static constexpr size_t kIndexedFrom = 8;
+    static constexpr bool kIndexed = N >= kIndexedFrom;
+    // Lengths from here up share the last group.
+    static constexpr size_t kLongLength = 32;
+
+    std::array<TokenEntry<T>, N> entries;
+    bool hasFallback = false;
+    T fallback{};
+    std::string_view fallbackToken{};
+    // Keys, tokens and values again, grouped by length (listing order within
+    // a length); group g is [lengthStart[g], lengthStart[g + 1]).
+    std::array<TokenKey, N> keys{};
+    std::array<std::string_view, N> tokens{};
+    std::array<T, N> values{};
+    std::array<uint8_t, kLongLength + 2> lengthStart{};
+
+    bool decode(std::string_view text, T& value) const {
+        if constexpr (!kIndexed) {
+            if (matchAny(text, value, std::make_index_sequence<N>{})) {
+                return true;
+            }
+        } else if (lookup(text, value)) {
+            return true;
+        }
+        if (hasFallback) {
+            value = fallback;
+        }
+        return hasFallback;
+    }
+    char* encode(T value, char* out) const {
+        std::string_view token = fallbackToken;
+        for (const auto& entry : entries) {
+            if (entry.value == value) {
+                token = entry.token;
+                break;
+            }
+        }
+        std::memcpy(out, token.data(), token.size());
+        return out + token.size();
+    }
+    constexpr size_t maxEncodedSize() const {
+        size_t longest = fallbackToken.size();
+        for (const auto& entry : entries) {
+            longest = entry.token.size() > longest ? entry.token.size() : longest;
+        }
+        return longest;
+    }
+    constexpr TokenCodec withFallback(T value, std::string_view token) const {
+        TokenCodec codec = *this;
+        codec.hasFallback = true;
+        codec.fallback = value;
+        codec.fallbackToken = token;
+        return codec;
+    }
+    // Most tokens sharing one length, i.e. the most key compares an indexed
+    // decode does.
+    constexpr size_t largestLengthGroup() const {
+        size_t largest = 0;
+        for (size_t g = 0; g <= kLongLength; ++g) {
+            const size_t size = static_cast<size_t>(lengthStart[g + 1] - lengthStart[g]);
+            largest = size > largest ? size : largest;
+        }
+        return largest;
+    }
+
+    // Unrolled so each comparison is against one table entry in turn.
+    template <size_t... I>
+    bool matchAny(std::string_view text, T& value, std::index_sequence<I...>) const {
+        return ((entries[I].token == text ? (value = entries[I].value, true) : false) || ...);
+    }
+
+    bool lookup(std::string_view text, T& value) const {
+        const size_t length = text.size() < kLongLength ? text.size() : kLongLength;
+        const size_t begin = lengthStart[length];
+        const size_t end = lengthStart[length + 1];
+        if (begin != end) {
+            const TokenKey key = tokenKey(text);
+            for (size_t i = begin; i < end; ++i) {
+                if (keys[i] == key && (key.size <= kTokenKeyExactBytes || tokens[i] == text)) {
+                    value = values[i];
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    constexpr void buildIndex() {
+        // Counting sort by length group; stable, so listing order is kept.
+        std::array<size_t, kLongLength + 2> start{};
+        for (size_t i = 0; i < N; ++i) {
+            ++start[groupOf(entries[i].token) + 1];
+        }
+        for (size_t g = 0; g <= kLongLength; ++g) {
+            start[g + 1] += start[g];
+        }
+        for (size_t g = 0; g < start.size(); ++g) {
+            lengthStart[g] = static_cast<uint8_t>(start[g]);
+        }
+        for (size_t i = 0; i < N; ++i) {
+            const size_t slot = start[groupOf(entries[i].token)]++;
+            keys[slot] = tokenKey(entries[i].token);
+            tokens[slot] = entries[i].token;
+            values[slot] = entries[i].value;
+        }
+    }
+
+    static constexpr size_t groupOf(std::string_view token) {
+        return token.size() < kLongLength ? token.size() : kLongLength;
+    }
+};
+
+template <typename T, size_t N, size_t... I>
+constexpr TokenCodec<T, N> makeTokenCodec(const TokenEntry<T> (&entries)[N], std::index_sequence<I...>) {
+    TokenCodec<T, N> codec{{{entries[I]...}}};
+    codec.buildIndex();
+    return codec;
+}
+
+template <typename T, size_t N>
+constexpr TokenCodec<T, N> tokenCodec(const TokenEntry<T> (&entries)[N]) {
+    return makeTokenCodec(entries, std::make_index_sequence<N>{});
+}
+
+template <auto Member, typename Codec>
+struct SchemaField {
+    std::string_view name;
+    Codec codec;
+
+    template <typename Record>
+    bool decode(std::string_view text, Record& record) const {
+        return codec.decode(text, record.*Member);
+    }
+    template <typename Record>
+    char* encode(const Record& record, char* out) const {
+        return codec.encode(record.*Member, out);
+    }
+};
+
+template <auto Member, typename Codec>
+constexpr SchemaField<Member, Codec> schemaField(std::string_view name, Codec codec) {
+    return SchemaField<Member, Codec>{name, codec};
+}
+
+struct SchemaDecodeResult {
+    enum class Error : uint8_t {
+        None = 0,
+        FieldCount,  // wrong number of fields; field is unused
+        Field,       // field failed its codec
+    };
+    Error error = Error::None;
+    size_t field = 0;
+
+    bool ok() const { return error == Error::None; }
+};
+
+template <typename Record, char Delimiter, typename... Fields>
+class RecordSchema {
+public:
+    static constexpr size_t kFieldCount = sizeof...(Fields);
+    static constexpr char kDelimiter = Delimiter;
+
+    constexpr explicit RecordSchema(Fields... fields) : fields_(fields...) {}
+
+    constexpr std::string_view fieldName(size_t index) const { return nameAt(index, Indices{}); }
+
+    // Upper bound on encode() output, delimiters included, newline excluded.
+    constexpr size_t maxLineSize() const { return maxSizes(Indices{}) + kFieldCount - 1; }
+
+    // Decodes fields already split by the caller. On a field error, record
+    // holds the fields decoded before it.
+    SchemaDecodeResult decodeFields(const std::string_view* fields, size_t fieldCount, Record& record) const {
+        if (fieldCount != kFieldCount) {
+            return SchemaDecodeResult{SchemaDecodeResult::Error::FieldCount, 0};
+        }
+        return decodeAll(fields, record, Indices{});
+    }
+
+    // Splits one line (without its '\n'; a trailing '\r' is ignored) and decodes it.
+    SchemaDecodeResult decodeLine(std::string_view line, Record& record) const {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        std::string_view fields[kFieldCount];
+        for (size_t i = 0; i + 1 < kFieldCount; ++i) {
+            size_t end = line.find(Delimiter);
+            if (end == std::string_view::npos) {
+                return SchemaDecodeResult{SchemaDecodeResult::Error::FieldCount, 0};
+            }
+            fields[i] = line.substr(0, end);
+            line.remove_prefix(end + 1);
+        }
+        if (line.find(Delimiter) != std::string_view::npos) {
+            return SchemaDecodeResult{SchemaDecodeResult::Error::FieldCount, 0};
+        }
+        fields[kFieldCount - 1] = line;
+        return decodeAll(fields, record, Indices{});
+    }
+
+    // Writes the record as one delimited line (no newline) into out, which
+    // must hold maxLineSize() bytes. Returns the end of the written text.
+    char* encode(const Record& record, char* out) const { return encodeAll(record, out, Indices{}); }
+
+private:
+    using Indices = std::index_sequence_for<Fields...>;
+
+    template <size_t... I>
+    SchemaDecodeResult decodeAll(const std::string_view* fields, Record& record, std::index_sequence<I...>) const {
+        size_t failed = kFieldCount;
+        // Stops at the first field that fails.
+        (void)((std::get<I>(fields_).decode(fields[I], record) || ((failed = I), false)) && ...);
+        if (failed != kFieldCount) {
+            return SchemaDecodeResult{SchemaDecodeResult::Error::Field, failed};
+        }
+        return SchemaDecodeResult{};
+    }
+
+    template <size_t... I>
+    char* encodeAll(const Record& record, char* out, std::index_sequence<I...>) const {
+        ((out = std::get<I>(fields_).encode(record, out), I + 1 < kFieldCount ? (void)(*out++ = Delimiter) : (void)0),
+         ...);
+        return out;
+    }
+
+    template <size_t... I>
+    constexpr size_t maxSizes(std::index_sequence<I...>) const {
+        return (std::get<I>(fields_).codec.maxEncodedSize() + ...);
+    }
+
+    template <size_t... I>
+    constexpr std::string_view nameAt(size_t index, std::index_sequence<I...>) const {
+        std::string_view names[] = {std::get<I>(fields_).name...};
+        return index < kFieldCount ? names[index] : std::string_view();
+    }
+
+    std::tuple<Fields...> fields_;
+};
+
+template <typename Record, char Delimiter, typename... Fields>
+constexpr RecordSchema<Record, Delimiter, Fields...> makeRecordSchema(Fields... fields) {
+    static_assert(sizeof...(Fields) > 0, "a schema needs at least one field");
+    return RecordSchema<Record, Delimiter, Fields...>(fields...);
+}
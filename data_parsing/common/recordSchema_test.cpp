@@ -0,0 +1,189 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "recordSchema.h"
+
+namespace {
+
+enum class FixKind : uint8_t {
+    None = 0,
+    TwoD,
+    ThreeD,
+};
+
+struct GpsFix {
+    int32_t vehicleId;
+    int64_t timestampNs;
+    double latitude;
+    double longitude;
+    FixKind fix;
+};
+
+constexpr TokenEntry<FixKind> kFixTokens[] = {
+    {"NONE", FixKind::None}, {"2D", FixKind::TwoD}, {"3D", FixKind::ThreeD},
+};
+
+constexpr auto kGpsSchema = makeRecordSchema<GpsFix, ';'>(
+    schemaField<&GpsFix::vehicleId>("vehicleId", IntCodec{}),
+    schemaField<&GpsFix::timestampNs>("timestamp", TimestampCodec{}),
+    schemaField<&GpsFix::latitude>("latitude", DecimalCodec{}),
+    schemaField<&GpsFix::longitude>("longitude", DecimalCodec{}),
+    schemaField<&GpsFix::fix>("fix", tokenCodec(kFixTokens)));
+
+struct TirePressure {
+    uint16_t wheel;
+    double kPa;
+    bool alarm;
+};
+
+constexpr TokenEntry<bool> kAlarmTokens[] = {{"0", false}, {"1", true}};
+
+constexpr auto kTireSchema = makeRecordSchema<TirePressure, ','>(
+    schemaField<&TirePressure::wheel>("wheel", IntCodec{}),
+    schemaField<&TirePressure::kPa>("kPa", DecimalCodec{}),
+    schemaField<&TirePressure::alarm>("alarm", tokenCodec(kAlarmTokens).withFallback(true, "1")));
+
+// Diagnostic trouble codes: a vocabulary larger than the feed's status table.
+constexpr TokenEntry<int> kTroubleCodes[] = {
+    {"P0100", 100}, {"P0101", 101}, {"P0102", 102}, {"P0110", 110}, {"P0115", 115}, {"P0120", 120},
+    {"P0171", 171}, {"P0172", 172}, {"P0174", 174}, {"P0300", 300}, {"P0301", 301}, {"P0302", 302},
+    {"P0420", 420}, {"P0430", 430}, {"P0442", 442}, {"P0455", 455}, {"P0500", 500}, {"P0505", 505},
+    {"U0100", 1100}, {"U0121", 1121}, {"B1000", 2000}, {"C0035", 3035}, {"OK", 0}, {"NO_DATA", -1},
+};
+constexpr auto kTroubleCodec = tokenCodec(kTroubleCodes).withFallback(-2, "UNKNOWN");
+
+// Tokens longer than a key holds, differing only in their last bytes; these
+// are confirmed with a string compare.
+constexpr TokenEntry<int> kFaultChannels[] = {
+    {"SENSOR_FAULT_CHANNEL_01", 1}, {"SENSOR_FAULT_CHANNEL_02", 2}, {"SENSOR_FAULT_CHANNEL_03", 3},
+    {"SENSOR_FAULT_CHANNEL_04", 4}, {"SENSOR_FAULT_CHANNEL_05", 5}, {"SENSOR_FAULT_CHANNEL_06", 6},
+    {"SENSOR_FAULT_CHANNEL_07", 7}, {"SENSOR_FAULT_CHANNEL_08", 8}, {"SENSOR_FAULT_CHANNEL_09", 9},
+    {"SENSOR_FAULT_CHANNEL_10", 10}, {"SENSOR_FAULT_CHANNEL_11", 11}, {"SENSOR_FAULT_CHANNEL_12", 12},
+    {"SENSOR_FAULT_CHANNEL_13", 13}, {"SENSOR_FAULT_CHANNEL_14", 14}, {"SENSOR_FAULT_CHANNEL_15", 15},
+    {"SENSOR_FAULT_CHANNEL_16", 16}, {"SENSOR_FAULT_CHANNEL_17", 17}, {"SENSOR_FAULT_CHANNEL_18", 18},
+    {"SENSOR_FAULT_CHANNEL_19", 19}, {"SENSOR_FAULT_CHANNEL_20", 20}, {"SENSOR_FAULT_CHANNEL_21", 21},
+    {"SENSOR_FAULT_CHANNEL_22", 22}, {"SENSOR_FAULT_CHANNEL_23", 23}, {"SENSOR_FAULT_CHANNEL_24", 24},
+    {"SENSOR_FAULT_CHANNEL_25", 25}, {"SENSOR_FAULT_CHANNEL_26", 26}, {"SENSOR_FAULT_CHANNEL_27", 27},
+    {"SENSOR_FAULT_CHANNEL_28", 28}, {"SENSOR_FAULT_CHANNEL_29", 29}, {"SENSOR_FAULT_CHANNEL_30", 30},
+    {"SENSOR_FAULT_CHANNEL_31", 31}, {"SENSOR_FAULT_CHANNEL_32", 32},
+};
+constexpr auto kFaultChannelCodec = tokenCodec(kFaultChannels);
+
+// Lengths of 32 and up share one group.
+constexpr TokenEntry<int> kLongTokens[] = {
+    {"VEHICLE_TELEMETRY_LINK_LOST_RECOVERING", 1}, {"VEHICLE_TELEMETRY_LINK_DEGRADED_MODE", 2},
+    {"VEHICLE_TELEMETRY_LINK_RESTORED_AFTER_LOSS", 3}, {"VEHICLE_TELEMETRY_BUFFER_OVERFLOW_DROP", 4},
+    {"VEHICLE_TELEMETRY_CLOCK_DRIFT_EXCEEDED", 5}, {"VEHICLE_TELEMETRY_CHECKSUM_MISMATCHED", 6},
+    {"VEHICLE_TELEMETRY_FIRMWARE_UPDATE_PENDING", 7}, {"VEHICLE_TELEMETRY_SESSION_REESTABLISHED", 8},
+};
+constexpr auto kLongCodec = tokenCodec(kLongTokens);
+
+// The same token twice: the first one listed wins.
+constexpr TokenEntry<int> kDuplicateTokens[] = {
+    {"A", 1}, {"A", 2}, {"B", 3}, {"C", 4}, {"D", 5}, {"E", 6}, {"F", 7}, {"G", 8},
+};
+constexpr auto kDuplicateCodec = tokenCodec(kDuplicateTokens);
+
+// Small tables are scanned; these are large enough for the length index.
+static_assert(!tokenCodec(kFixTokens).kIndexed && kTroubleCodec.kIndexed && kFaultChannelCodec.kIndexed);
+static_assert(kLongCodec.kIndexed && kDuplicateCodec.kIndexed);
+static_assert(kTroubleCodec.largestLengthGroup() == 22);  // every "Pnnnn"-style code
+static_assert(kFaultChannelCodec.largestLengthGroup() == 32);
+static_assert(kLongCodec.largestLengthGroup() == 8);
+static_assert(kDuplicateCodec.largestLengthGroup() == 8);
+
+// Everything a schema knows about itself is available at compile time.
+static_assert(kGpsSchema.kFieldCount == 5);
+static_assert(kGpsSchema.fieldName(2) == "latitude");
+static_assert(kGpsSchema.maxLineSize() == 20 + kTimestampTextLen + 24 + 24 + 4 + 4);
+
+}  // namespace
+
+int main() {
+    std::cout << "[Test] starting record schema tests\n";
+
+    // Test 1: decode a line, encode it back to the same text.
+    {
+        const std::string_view line = "1001;2026-02-14 10:15:23;48.137154;11.576124;3D";
+        GpsFix fix{};
+        assert(kGpsSchema.decodeLine(line, fix).ok());
+        assert(fix.vehicleId == 1001);
+        assert(fix.timestampNs == 1771064123LL * kNanosPerSecond);
+        assert(fix.latitude == 48.137154);
+        assert(fix.fix == FixKind::ThreeD);
+
+        char out[kGpsSchema.maxLineSize()];
+        char* end = kGpsSchema.encode(fix, out);
+        assert(std::string_view(out, static_cast<size_t>(end - out)) == line);
+        std::cout << "[Test1] round trip ok\n";
+    }
+
+    // Test 2: failures name the field; field count is checked both ways.
+    {
+        GpsFix fix{};
+        auto result = kGpsSchema.decodeLine("1001;2026-02-14 10:15:23;north;11.5;3D", fix);
+        assert(result.error == SchemaDecodeResult::Error::Field && result.field == 2);
+        assert(kGpsSchema.fieldName(result.field) == "latitude");
+        result = kGpsSchema.decodeLine("1001;2026-02-14 10:15:23;1.0;2.0;4D", fix);
+        assert(result.error == SchemaDecodeResult::Error::Field && result.field == 4);
+        result = kGpsSchema.decodeLine("1001;2026-02-14 10:15:23;1.0;2.0", fix);
+        assert(result.error == SchemaDecodeResult::Error::FieldCount);
+        result = kGpsSchema.decodeLine("1001;2026-02-14 10:15:23;1.0;2.0;3D;extra", fix);
+        assert(result.error == SchemaDecodeResult::Error::FieldCount);
+        result = kGpsSchema.decodeLine("1001;2026-02-14 10:15:23;1.0;2.0;2D\r", fix);
+        assert(result.ok() && fix.fix == FixKind::TwoD);
+        // Integer fields reject trailing junk and out-of-range values.
+        TirePressure tire{};
+        assert(!kTireSchema.decodeLine("3x,220.5,0", tire).ok());
+        assert(!kTireSchema.decodeLine("70000,220.5,0", tire).ok());
+        std::cout << "[Test2] field errors ok\n";
+    }
+
+    // Test 3: a token fallback accepts unknown spellings and encodes them as the fallback token.
+    {
+        TirePressure tire{};
+        assert(kTireSchema.decodeLine("3,180.25,LOW", tire).ok());
+        assert(tire.wheel == 3 && tire.kPa == 180.25 && tire.alarm);
+        char out[kTireSchema.maxLineSize()];
+        char* end = kTireSchema.encode(tire, out);
+        assert(std::string_view(out, static_cast<size_t>(end - out)) == "3,180.25,1");
+
+        // Pre-split fields decode the same way.
+        std::string_view fields[] = {"2", "230", "0"};
+        assert(kTireSchema.decodeFields(fields, 3, tire).ok());
+        assert(tire.wheel == 2 && tire.kPa == 230.0 && !tire.alarm);
+        assert(kTireSchema.decodeFields(fields, 2, tire).error == SchemaDecodeResult::Error::FieldCount);
+        std::cout << "[Test3] token fallback ok\n";
+    }
+
+    // Test 4: length-grouped token lookup finds every token and nothing else.
+    {
+        int value = 0;
+        for (const auto& entry : kTroubleCodes) {
+            assert(kTroubleCodec.decode(entry.token, value) && value == entry.value);
+        }
+        for (std::string_view unknown : {"", "P", "P010", "P01000", "P0103", "Q0100", "ok", "NO_DATA ", "0100P"}) {
+            assert(kTroubleCodec.decode(unknown, value) && value == -2);
+        }
+        for (const auto& entry : kFaultChannels) {
+            assert(kFaultChannelCodec.decode(entry.token, value) && value == entry.value);
+        }
+        assert(!kFaultChannelCodec.decode("SENSOR_FAULT_CHANNEL_33", value));
+        assert(!kFaultChannelCodec.decode("SENSOR_FAULT_CHANNEL_1", value));
+        for (const auto& entry : kLongTokens) {
+            assert(kLongCodec.decode(entry.token, value) && value == entry.value);
+        }
+        assert(!kLongCodec.decode("VEHICLE_TELEMETRY_LINK_LOST_RECOVERING_", value));
+        assert(!kLongCodec.decode("VEHICLE_TELEMETRY_LINK_DEGRADED_MODX", value));
+        assert(kDuplicateCodec.decode("A", value) && value == 1);
+        assert(kDuplicateCodec.decode("B", value) && value == 3);
+        assert(kDuplicateCodec.decode("G", value) && value == 8);
+        assert(!kDuplicateCodec.decode("H", value));
+        std::cout << "[Test4] token lookup ok\n";
+    }
+
+    std::cout << "\n[Test] all record schema tests passed\n";
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include "shmRing.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t kRingMagic = 0x56524E47;  // "VRNG"
+constexpr uint32_t kWrapMarker = UINT32_MAX;
+constexpr size_t kFrameHeader = sizeof(uint32_t);
+constexpr int kSpinsBeforeSleep = 256;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indices must be lock-free across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex words must be lock-free across processes");
+
+inline size_t frameSize(size_t len) {
+    return (kFrameHeader + len + 7) & ~size_t{7};
+}
+
+// A negative timeout waits until woken.
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout) {
+    struct timespec ts;
+    ts.tv_sec = timeout.count() / 1000;
+    ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout.count() < 0 ? nullptr : &ts,
+            nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+struct ShmRing::Header {
+    std::atomic<uint32_t> magic;
+    uint32_t reserved;
+    uint64_t capacity;
+
+    alignas(64) std::atomic<uint64_t> head;  // written by producer
+    alignas(64) std::atomic<uint64_t> tail;  // written by consumer
+
+    alignas(64) std::atomic<uint32_t> dataSeq;    // bumped when the producer publishes
+    std::atomic<uint32_t> consumerWaiting;
+    alignas(64) std::atomic<uint32_t> spaceSeq;   // bumped when the consumer frees space
+    std::atomic<uint32_t> producerWaiting;
+};
+
+ShmRing::~ShmRing() {
+    if (header_ != nullptr) {
+        munmap(header_, mappedSize_);
+    }
+}
+
+bool ShmRing::open(const std::string& name, size_t capacity) {
+    name_ = name;
+    capacity = (capacity + 7) & ~size_t{7};
+    const size_t headerSize = (sizeof(Header) + 63) & ~size_t{63};
+    mappedSize_ = headerSize + capacity;
+
+    bool creator = true;
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd == -1 && errno == EEXIST) {
+        creator = false;
+        fd = shm_open(name.c_str(), O_RDWR, 0666);
+    }
+    if (fd == -1) {
+        perror("shm_open");
+        return false;
+    }
+    if (creator && ftruncate(fd, static_cast<off_t>(mappedSize_)) == -1) {
+        perror("ftruncate");
+        ::close(fd);
+        return false;
+    }
+    if (!creator) {
+        // The creator may still be sizing the segment.
+        struct stat st {};
+        for (int i = 0; i < 1000 && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < mappedSize_; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (static_cast<size_t>(st.st_size) != mappedSize_) {
+            std::fprintf(stderr, "shm ring %s has unexpected size %lld\n", name.c_str(),
+                         static_cast<long long>(st.st_size));
+            ::close(fd);
+            return false;
+        }
+    }
+    void* addr = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    header_ = static_cast<Header*>(addr);
+    data_ = static_cast<unsigned char*>(addr) + headerSize;
+
+    if (creator) {
+        // ftruncate zero-fills, so only the capacity and magic need writing; magic goes last.
+        header_->capacity = capacity;
+        header_->magic.store(kRingMagic, std::memory_order_release);
+    } else {
+        for (int i = 0; i < 1000 && header_->magic.load(std::memory_order_acquire) != kRingMagic; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header_->magic.load(std::memory_order_acquire) != kRingMagic || header_->capacity != capacity) {
+            std::fprintf(stderr, "shm ring %s is not initialised or has another capacity\n", name.c_str());
+            return false;
+        }
+    }
+    cachedHead_ = header_->head.load(std::memory_order_acquire);
+    cachedTail_ = header_->tail.load(std::memory_order_acquire);
+    return true;
+}
+
+void ShmRing::unlink() {
+    if (!name_.empty()) {
+        shm_unlink(name_.c_str());
+    }
+}
+
+size_t ShmRing::maxMessageSize() const {
+    // A frame may need to skip the end of the ring, so keep messages to half of it.
+    return header_ != nullptr ? header_->capacity / 2 - kFrameHeader : 0;
+}
+
+bool ShmRing::push(const unsigned char* data, size_t len) {
+    if (len > maxMessageSize()) {
+        std::fprintf(stderr, "shm ring message of %zu bytes exceeds %zu\n", len, maxMessageSize());
+        return false;
+    }
+    const uint64_t capacity = header_->capacity;
+    const uint64_t head = header_->head.load(std::memory_order_relaxed);
+    const size_t offset = head % capacity;
+    const size_t frame = frameSize(len);
+    const size_t skip = capacity - offset < frame ? capacity - offset : 0;
+    const size_t needed = skip + frame;
+
+    int spins = 0;
+    while (capacity - (head - cachedTail_) < needed) {
+        cachedTail_ = header_->tail.load(std::memory_order_acquire);
+        if (capacity - (head - cachedTail_) >= needed) {
+            break;
+        }
+        if (++spins < kSpinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t seq = header_->spaceSeq.load(std::memory_order_acquire);
+        header_->producerWaiting.store(1, std::memory_order_seq_cst);
+        if (capacity - (head - header_->tail.load(std::memory_order_seq_cst)) < needed) {
+            futexWait(&header_->spaceSeq, seq, std::chrono::milliseconds(100));
+        }
+        header_->producerWaiting.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t writePos = head;
+    if (skip != 0) {
+        uint32_t marker = kWrapMarker;
+        std::memcpy(data_ + offset, &marker, sizeof(marker));
+        writePos += skip;
+    }
+    uint32_t frameLen = static_cast<uint32_t>(len);
+    unsigned char* frameStart = data_ + writePos % capacity;
+    std::memcpy(frameStart, &frameLen, sizeof(frameLen));
+    if (len != 0) {
+        std::memcpy(frameStart + kFrameHeader, data, len);
+    }
+    header_->head.store(writePos + frame, std::memory_order_seq_cst);
+
+    if (header_->consumerWaiting.load(std::memory_order_seq_cst) != 0) {
+        header_->dataSeq.fetch_add(1, std::memory_order_release);
+        futexWake(&header_->dataSeq);
+    }
+    return true;
+}
+
+bool ShmRing::tryPop(unsigned char* buf, size_t cap, size_t& len) {
+    const uint64_t capacity = header_->capacity;
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (tail == cachedHead_) {
+        cachedHead_ = header_->head.load(std::memory_order_acquire);
+        if (tail == cachedHead_) {
+            return false;
+        }
+    }
+    uint32_t frameLen;
+    std::memcpy(&frameLen, data_ + tail % capacity, sizeof(frameLen));
+    if (frameLen == kWrapMarker) {
+        tail += capacity - tail % capacity;
+        std::memcpy(&frameLen, data_ + tail % capacity, sizeof(frameLen));
+    }
+    len = std::min<size_t>(frameLen, cap);
+    if (len != 0) {
+        std::memcpy(buf, data_ + tail % capacity + kFrameHeader, len);
+    }
+    header_->tail.store(tail + frameSize(frameLen), std::memory_order_seq_cst);
+
+    if (header_->producerWaiting.load(std::memory_order_seq_cst) != 0) {
+        header_->spaceSeq.fetch_add(1, std::memory_order_release);
+        futexWake(&header_->spaceSeq);
+    }
+    return true;
+}
+
+bool ShmRing::pop(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) {
+    for (int spin = 0; spin < kSpinsBeforeSleep; ++spin) {
+        if (tryPop(buf, cap, len)) {
+            return true;
+        }
+    }
+    const bool forever = timeout.count() < 0;
+    auto deadline = std::chrono::steady_clock::now() + (forever ? std::chrono::milliseconds(0) : timeout);
+    while (true) {
+        uint32_t seq = header_->dataSeq.load(std::memory_order_acquire);
+        header_->consumerWaiting.store(1, std::memory_order_seq_cst);
+        if (tryPop(buf, cap, len)) {
+            header_->consumerWaiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!forever && now >= deadline) {
+            header_->consumerWaiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        futexWait(&header_->dataSeq, seq,
+                  forever ? timeout
+                          : std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) +
+                                std::chrono::milliseconds(1));
+        header_->consumerWaiting.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr const char* kShmRingName = "/vehicle_data_ring";
+constexpr size_t kShmRingCapacity = 8 << 20;
+
+// Single-producer/single-consumer ring of length-prefixed messages in POSIX
+// shared memory. Head and tail live on separate cache lines; either side
+// sleeps on a process-shared futex only when the ring is empty (consumer) or
+// full (producer), and the other side wakes it only if it is actually asleep.
+class ShmRing {
+public:
+    ShmRing() = default;
+    ~ShmRing();
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Creates the segment, or attaches to one the other process created.
+    bool open(const std::string& name, size_t capacity);
+    void unlink();
+
+    // Producer side. Blocks while the ring is full.
+    bool push(const unsigned char* data, size_t len);
+    // Consumer side. Returns false if nothing arrived within timeout; a
+    // negative timeout waits indefinitely.
+    bool pop(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout);
+
+    size_t maxMessageSize() const;
+
+private:
+    struct Header;
+
+    bool tryPop(unsigned char* buf, size_t cap, size_t& len);
+
+    std::string name_;
+    Header* header_ = nullptr;
+    unsigned char* data_ = nullptr;
+    size_t mappedSize_ = 0;
+    uint64_t cachedHead_ = 0;  // consumer's last view of head
+    uint64_t cachedTail_ = 0;  // producer's last view of tail
+};
@@ -0,0 +1,60 @@
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "shmRing.h"
+
+int main() {
+    std::cout << "[Test] starting shm ring tests\n";
+    const std::string name = "/vehicle_ring_test_" + std::to_string(getpid());
+    // Small ring so the producer wraps and blocks on a full ring many times.
+    constexpr size_t kCapacity = 4096;
+    constexpr uint32_t kMessages = 200000;
+
+    ShmRing consumer;
+    assert(consumer.open(name, kCapacity));
+
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        ShmRing producer;
+        if (!producer.open(name, kCapacity)) { _exit(1); }
+        std::vector<unsigned char> buf(producer.maxMessageSize());
+        for (uint32_t i = 0; i < kMessages; ++i) {
+            size_t len = sizeof(i) + i % 700;
+            std::memcpy(buf.data(), &i, sizeof(i));
+            std::memset(buf.data() + sizeof(i), static_cast<int>(i & 0xff), len - sizeof(i));
+            if (!producer.push(buf.data(), len)) { _exit(2); }
+        }
+        producer.push(nullptr, 0);
+        _exit(0);
+    }
+
+    std::vector<unsigned char> buf(consumer.maxMessageSize());
+    uint32_t expected = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        size_t len = 0;
+        assert(consumer.pop(buf.data(), buf.size(), len, std::chrono::seconds(5)));
+        if (len == 0) { break; }
+        uint32_t seq;
+        std::memcpy(&seq, buf.data(), sizeof(seq));
+        assert(seq == expected);
+        assert(len == sizeof(seq) + seq % 700);
+        for (size_t i = sizeof(seq); i < len; ++i) { assert(buf[i] == (seq & 0xff)); }
+        ++expected;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int status = 0;
+    waitpid(pid, &status, 0);
+    consumer.unlink();
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(expected == kMessages);
+    std::cout << "[Test1] " << expected << " messages in order, " << expected / seconds << " msg/s\n";
+
+    std::cout << "\n[Test] all shm ring tests passed\n";
+    return 0;
+}
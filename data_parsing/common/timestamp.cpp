@@ -0,0 +1,115 @@
+#include "timestamp.h"
+
+namespace {
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+constexpr int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+constexpr void civilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0, "epoch must map to day 0");
+
+constexpr bool isLeapYear(int64_t y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+constexpr unsigned daysInMonth(int64_t y, unsigned m) {
+    constexpr unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && isLeapYear(y) ? 29 : kDays[m - 1];
+}
+
+// Reads n ASCII digits starting at p; false if any byte is not a digit.
+inline bool readDigits(const char* p, int n, unsigned& out) {
+    unsigned value = 0;
+    for (int i = 0; i < n; ++i) {
+        unsigned digit = static_cast<unsigned char>(p[i]) - '0';
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+inline void writeDigits(char* p, int n, unsigned value) {
+    for (int i = n - 1; i >= 0; --i) {
+        p[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+}  // namespace
+
+bool parseTimestamp(std::string_view text, int64_t& epochNs) {
+    if (text.size() != kTimestampTextLen || text[4] != '-' || text[7] != '-' || text[10] != ' ' ||
+        text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+    const char* p = text.data();
+    unsigned year, month, day, hour, minute, second;
+    if (!readDigits(p, 4, year) || !readDigits(p + 5, 2, month) || !readDigits(p + 8, 2, day) ||
+        !readDigits(p + 11, 2, hour) || !readDigits(p + 14, 2, minute) || !readDigits(p + 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59 ||
+        second > 59) {
+        return false;
+    }
+    const int64_t days = daysFromCivil(year, month, day);
+    const int64_t seconds = (days * 24 + hour) * 3600 + minute * 60 + second;
+    // int64 nanoseconds span 1677-09-21 00:12:44 to 2262-04-11 23:47:16; a
+    // four-digit year can fall outside that, and must not wrap around.
+    if (seconds > INT64_MAX / kNanosPerSecond || seconds < INT64_MIN / kNanosPerSecond) {
+        return false;
+    }
+    epochNs = seconds * kNanosPerSecond;
+    return true;
+}
+
+size_t formatTimestamp(int64_t epochNs, char* out) {
+    int64_t seconds = epochNs / kNanosPerSecond;
+    if (epochNs % kNanosPerSecond < 0) {
+        --seconds;  // floor toward negative infinity for pre-epoch values
+    }
+    int64_t days = seconds / 86400;
+    int64_t secOfDay = seconds % 86400;
+    if (secOfDay < 0) {
+        secOfDay += 86400;
+        --days;
+    }
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    writeDigits(out, 4, static_cast<unsigned>(year));
+    out[4] = '-';
+    writeDigits(out + 5, 2, month);
+    out[7] = '-';
+    writeDigits(out + 8, 2, day);
+    out[10] = ' ';
+    writeDigits(out + 11, 2, static_cast<unsigned>(secOfDay / 3600));
+    out[13] = ':';
+    writeDigits(out + 14, 2, static_cast<unsigned>(secOfDay / 60 % 60));
+    out[16] = ':';
+    writeDigits(out + 17, 2, static_cast<unsigned>(secOfDay % 60));
+    out[kTimestampTextLen] = '\0';
+    return kTimestampTextLen;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+constexpr int64_t kNanosPerSecond = 1'000'000'000;
+
+// Length of the fixed "YYYY-MM-DD HH:MM:SS" layout used by the telemetry feed.
+constexpr size_t kTimestampTextLen = 19;
+
+// Parses exactly "YYYY-MM-DD HH:MM:SS" (UTC) into nanoseconds since the Unix
+// epoch. No locale, no strptime; returns false on any layout or range error,
+// including dates outside what int64 nanoseconds can hold (1677..2262).
+bool parseTimestamp(std::string_view text, int64_t& epochNs);
+
+// Writes "YYYY-MM-DD HH:MM:SS" for epochNs into out, which must hold at least
+// kTimestampTextLen + 1 bytes. Sub-second digits are dropped. Returns the length.
+size_t formatTimestamp(int64_t epochNs, char* out);
+
+// Start of the fixed-width window holding epochNs. Floors toward negative
+// infinity so pre-epoch records land in the right bucket; windowNs must be > 0.
+inline int64_t timestampWindowStart(int64_t epochNs, int64_t windowNs) {
+    int64_t rem = epochNs % windowNs;
+    return epochNs - (rem < 0 ? rem + windowNs : rem);
+}
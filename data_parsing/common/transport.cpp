@@ -0,0 +1,738 @@
+#include "transport.h"
+#include "shmRing.h"
+#include "vehicleWire.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr const char* kMqueueName = "/vehicle_data_mq";
+constexpr const char* kSocketPath = "/tmp/vehicle_data.sock";
+constexpr const char* kFifoPath = "/tmp/vehicle_data.fifo";
+
+// Partition 0 keeps the unsuffixed name so single-consumer setups are unchanged.
+std::string partitionedName(const char* base, uint32_t partition) {
+    std::string name(base);
+    if (partition > 0) {
+        name += '.';
+        name += std::to_string(partition);
+    }
+    return name;
+}
+
+size_t systemMsgMax() {
+    std::ifstream proc("/proc/sys/kernel/msgmax");
+    size_t value = 0;
+    if (proc >> value && value > 0) {
+        return value;
+    }
+    return 8192;  // Linux default
+}
+
+// Every partition shares one queue and is told apart by mtype, so each
+// receiver's msgrcv only ever sees its own partition, in order. Faults use
+// the type just below the partition's records type. Partition 0's two types
+// are the lowest on the queue, so one msgrcv(-recordsType) returns faults
+// first. Other partitions cannot use a negative type without stealing lower
+// partitions' messages. They check their fault type without blocking before
+// each receive, and after a fault the sender posts a one-byte wake-up on the
+// records type so a receiver asleep on that type goes back to check faults.
+//
+// Sends never block blindly: msgsnd runs with IPC_NOWAIT and a full queue
+// (EAGAIN) is retried with exponential backoff, falling back to a blocking
+// msgsnd after kMaxSendRetries so no batch is dropped. Every EAGAIN, every
+// fallback and the total time spent waiting are counted, and the queue depth
+// is sampled with IPC_STAT every kStatInterval while sending.
+class SysVQueueTransport : public Transport {
+public:
+    SysVQueueTransport(uint32_t partition, const TransportTuning& tuning)
+        : partition_(partition),
+          faultType_(kMsgTypeFaults + 2 * static_cast<long>(partition)),
+          recordsType_(kMsgTypeRecords + 2 * static_cast<long>(partition)),
+          tuning_(tuning) {}
+
+    bool open() {
+        msgId_ = msgget(MSG_QUEUE_KEY, IPC_CREAT | 0666);
+        if (msgId_ == -1) {
+            perror("msgget");
+            return false;
+        }
+        maxMessage_ = std::min(systemMsgMax(), kMaxMsgPayload);
+        if (tuning_.sysvQueueBytes != 0) {
+            setQueueBytes(tuning_.sysvQueueBytes);
+        }
+        // A message larger than msg_qbytes never fits, so msgsnd would wait forever.
+        struct msqid_ds ds {};
+        if (msgctl(msgId_, IPC_STAT, &ds) == 0) {
+            qbytes_ = ds.msg_qbytes;
+            if (qbytes_ != 0 && qbytes_ < maxMessage_) {
+                maxMessage_ = static_cast<size_t>(qbytes_);
+            }
+        }
+        return true;
+    }
+
+    bool send(const unsigned char* data, size_t len) override { return sendTyped(recordsType_, data, len); }
+
+    bool sendPriority(const unsigned char* data, size_t len) override {
+        if (!sendTyped(faultType_, data, len)) {
+            return false;
+        }
+        static const unsigned char kWake = 0;
+        return partition_ == 0 || sendTyped(recordsType_, &kWake, kWakeLen);
+    }
+
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        // msgrcv has no timeout: block outright when waiting forever, otherwise
+        // fall back to short IPC_NOWAIT polls until the deadline.
+        constexpr auto kPollSleep = std::chrono::milliseconds(1);
+        const bool blocking = timeout == kWaitForever;
+        auto deadline = std::chrono::steady_clock::now() + (blocking ? std::chrono::milliseconds(0) : timeout);
+        while (true) {
+            ssize_t received = -1;
+            if (partition_ == 0) {
+                received = msgrcv(msgId_, msg_.get(), sizeof(msg_->payload), -recordsType_, blocking ? 0 : IPC_NOWAIT);
+            } else {
+                received = msgrcv(msgId_, msg_.get(), sizeof(msg_->payload), faultType_, IPC_NOWAIT);
+                if (received == -1 && errno == ENOMSG) {
+                    received = msgrcv(msgId_, msg_.get(), sizeof(msg_->payload), recordsType_,
+                                      blocking ? 0 : IPC_NOWAIT);
+                }
+            }
+            if (received != -1) {
+                if (msg_->type == recordsType_ && received == static_cast<ssize_t>(kWakeLen)) {
+                    continue;  // wake-up after a fault; go round and take it
+                }
+                len = std::min(static_cast<size_t>(received), cap);
+                std::memcpy(buf, msg_->payload, len);
+                return len == 0 ? RecvStatus::E_EndOfStream : RecvStatus::E_OK;
+            }
+            if (errno == ENOMSG) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return RecvStatus::E_Timeout;
+                }
+                std::this_thread::sleep_for(kPollSleep);
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("msgrcv");
+            return RecvStatus::E_Error;
+        }
+    }
+
+    size_t maxMessageSize() const override { return maxMessage_; }
+    const char* name() const override { return "sysv"; }
+
+    void printStats(std::ostream& os) const override {
+        if (sends_ == 0) {
+            return;
+        }
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "SysV queue: sends: %llu, EAGAIN: %llu, blocking fallbacks: %llu, stalled: %.2f ms "
+                      "(max %.2f ms)\n",
+                      static_cast<unsigned long long>(sends_), static_cast<unsigned long long>(eagains_),
+                      static_cast<unsigned long long>(blockingFallbacks_), stallNs_ / 1e6, maxStallNs_ / 1e6);
+        os << line;
+        if (samples_ > 0) {
+            std::snprintf(line, sizeof(line),
+                          "SysV queue depth (%llu IPC_STAT samples): messages mean %.1f max %llu, "
+                          "bytes mean %.0f max %llu of %llu\n",
+                          static_cast<unsigned long long>(samples_), static_cast<double>(sumQnum_) / samples_,
+                          static_cast<unsigned long long>(maxQnum_), static_cast<double>(sumCbytes_) / samples_,
+                          static_cast<unsigned long long>(maxCbytes_), static_cast<unsigned long long>(qbytes_));
+            os << line;
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Real batches are at least a header long, so a single byte cannot be data.
+    static constexpr size_t kWakeLen = 1;
+    static constexpr int kMaxSendRetries = 10;
+    static constexpr auto kFirstBackoff = std::chrono::microseconds(20);
+    static constexpr auto kMaxBackoff = std::chrono::milliseconds(2);
+    static constexpr auto kStatInterval = std::chrono::milliseconds(100);
+
+    void setQueueBytes(size_t bytes) {
+        struct msqid_ds ds {};
+        if (msgctl(msgId_, IPC_STAT, &ds) == -1) {
+            perror("msgctl(IPC_STAT)");
+            return;
+        }
+        ds.msg_qbytes = static_cast<msglen_t>(bytes);
+        // Not fatal: the queue still works at its old size, only slower under bursts.
+        if (msgctl(msgId_, IPC_SET, &ds) == -1) {
+            std::fprintf(stderr, "msgctl(IPC_SET msg_qbytes=%zu): %s; keeping the current limit\n", bytes,
+                         std::strerror(errno));
+        }
+    }
+
+    void sampleQueue(Clock::time_point now) {
+        nextSample_ = now + kStatInterval;
+        struct msqid_ds ds {};
+        if (msgctl(msgId_, IPC_STAT, &ds) == -1) {
+            return;
+        }
+        ++samples_;
+        sumQnum_ += ds.msg_qnum;
+        sumCbytes_ += ds.__msg_cbytes;
+        maxQnum_ = std::max<uint64_t>(maxQnum_, ds.msg_qnum);
+        maxCbytes_ = std::max<uint64_t>(maxCbytes_, ds.__msg_cbytes);
+        qbytes_ = ds.msg_qbytes;
+    }
+
+    bool sendTyped(long type, const unsigned char* data, size_t len) {
+        msg_->type = type;
+        if (len != 0) {
+            std::memcpy(msg_->payload, data, len);
+        }
+        ++sends_;
+        auto now = Clock::now();
+        if (now >= nextSample_) {
+            sampleQueue(now);
+        }
+
+        Clock::time_point stallStart{};
+        auto backoff = std::chrono::duration_cast<std::chrono::microseconds>(kFirstBackoff);
+        int retries = 0;
+        int flags = IPC_NOWAIT;
+        while (msgsnd(msgId_, msg_.get(), len, flags) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN) {
+                perror("msgsnd");
+                return false;
+            }
+            ++eagains_;
+            if (retries == 0) {
+                stallStart = Clock::now();
+            }
+            if (++retries > kMaxSendRetries) {
+                // The receiver is not keeping up; wait in the kernel instead of spinning.
+                ++blockingFallbacks_;
+                flags = 0;
+                continue;
+            }
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min<std::chrono::microseconds>(backoff * 2, kMaxBackoff);
+        }
+        if (retries > 0) {
+            auto stalled = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - stallStart).count();
+            stallNs_ += static_cast<uint64_t>(stalled);
+            maxStallNs_ = std::max<uint64_t>(maxStallNs_, static_cast<uint64_t>(stalled));
+        }
+        return true;
+    }
+
+    uint32_t partition_;
+    long faultType_;
+    long recordsType_;
+    TransportTuning tuning_;
+    int msgId_ = -1;
+    size_t maxMessage_ = 0;
+
+    uint64_t sends_ = 0;
+    uint64_t eagains_ = 0;
+    uint64_t blockingFallbacks_ = 0;
+    uint64_t stallNs_ = 0;
+    uint64_t maxStallNs_ = 0;
+    Clock::time_point nextSample_{};
+    uint64_t samples_ = 0;
+    uint64_t sumQnum_ = 0;
+    uint64_t sumCbytes_ = 0;
+    uint64_t maxQnum_ = 0;
+    uint64_t maxCbytes_ = 0;
+    uint64_t qbytes_ = 0;
+    std::unique_ptr<Msg> msg_ = std::make_unique<Msg>();
+};
+
+class ShmRingTransport : public Transport {
+public:
+    ShmRingTransport(TransportRole role, uint32_t partition)
+        : role_(role), name_(partitionedName(kShmRingName, partition)) {}
+
+    ~ShmRingTransport() override {
+        // The consumer owns cleanup so a restarted sender finds a fresh ring.
+        if (role_ == TransportRole::Receiver) {
+            ring_.unlink();
+        }
+    }
+
+    bool open() { return ring_.open(name_.c_str(), kShmRingCapacity); }
+
+    bool send(const unsigned char* data, size_t len) override { return ring_.push(data, len); }
+
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        if (!ring_.pop(buf, cap, len, timeout)) {
+            return RecvStatus::E_Timeout;
+        }
+        return len == 0 ? RecvStatus::E_EndOfStream : RecvStatus::E_OK;
+    }
+
+    size_t maxMessageSize() const override { return std::min(ring_.maxMessageSize(), kMaxMsgPayload); }
+    const char* name() const override { return "shm"; }
+
+private:
+    TransportRole role_;
+    std::string name_;
+    ShmRing ring_;
+};
+
+class PosixMqueueTransport : public Transport {
+public:
+    PosixMqueueTransport(TransportRole role, uint32_t partition)
+        : role_(role), name_(partitionedName(kMqueueName, partition)) {}
+
+    ~PosixMqueueTransport() override {
+        if (mq_ != static_cast<mqd_t>(-1)) {
+            mq_close(mq_);
+        }
+        if (role_ == TransportRole::Receiver) {
+            mq_unlink(name_.c_str());
+        }
+    }
+
+    bool open() {
+        // Stay within the default fs.mqueue limits (msg_max 10, msgsize_max 8192).
+        struct mq_attr attr {};
+        attr.mq_maxmsg = 10;
+        attr.mq_msgsize = 8192;
+        mq_ = mq_open(name_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666, &attr);
+        if (mq_ == static_cast<mqd_t>(-1)) {
+            perror("mq_open");
+            return false;
+        }
+        if (mq_getattr(mq_, &attr) == -1) {
+            perror("mq_getattr");
+            return false;
+        }
+        maxMessage_ = static_cast<size_t>(attr.mq_msgsize);
+        return true;
+    }
+
+    bool send(const unsigned char* data, size_t len) override { return sendWithPriority(data, len, 0); }
+
+    // mq_receive always returns the oldest message of the highest priority.
+    bool sendPriority(const unsigned char* data, size_t len) override {
+        return sendWithPriority(data, len, kFaultPriority);
+    }
+
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        if (scratch_.size() < maxMessage_) {
+            scratch_.resize(maxMessage_);
+        }
+        struct timespec deadline = deadlineAfter(timeout);
+        while (true) {
+            char* scratch = reinterpret_cast<char*>(scratch_.data());
+            ssize_t received = timeout == kWaitForever
+                                   ? mq_receive(mq_, scratch, scratch_.size(), nullptr)
+                                   : mq_timedreceive(mq_, scratch, scratch_.size(), nullptr, &deadline);
+            if (received != -1) {
+                len = std::min(static_cast<size_t>(received), cap);
+                std::memcpy(buf, scratch_.data(), len);
+                return len == 0 ? RecvStatus::E_EndOfStream : RecvStatus::E_OK;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ETIMEDOUT) {
+                return RecvStatus::E_Timeout;
+            }
+            perror("mq_timedreceive");
+            return RecvStatus::E_Error;
+        }
+    }
+
+    size_t maxMessageSize() const override { return maxMessage_; }
+    const char* name() const override { return "mqueue"; }
+
+private:
+    static constexpr unsigned kFaultPriority = 1;
+
+    bool sendWithPriority(const unsigned char* data, size_t len, unsigned priority) {
+        static const char kEmpty = 0;
+        const char* bytes = len != 0 ? reinterpret_cast<const char*>(data) : &kEmpty;
+        while (mq_send(mq_, bytes, len, priority) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("mq_send");
+            return false;
+        }
+        return true;
+    }
+
+    static struct timespec deadlineAfter(std::chrono::milliseconds timeout) {
+        struct timespec ts {};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        auto nanos = static_cast<long long>(ts.tv_nsec) + static_cast<long long>(timeout.count() % 1000) * 1000000;
+        ts.tv_sec += timeout.count() / 1000 + nanos / 1000000000;
+        ts.tv_nsec = nanos % 1000000000;
+        return ts;
+    }
+
+    TransportRole role_;
+    std::string name_;
+    mqd_t mq_ = static_cast<mqd_t>(-1);
+    size_t maxMessage_ = 0;
+    std::vector<unsigned char> scratch_;
+};
+
+// Waits for fd to become readable; false on timeout or error (errno set).
+bool waitReadable(int fd, std::chrono::milliseconds timeout) {
+    struct pollfd pfd {fd, POLLIN, 0};
+    while (true) {
+        int ready = poll(&pfd, 1, static_cast<int>(timeout.count()));
+        if (ready > 0) {
+            return true;
+        }
+        if (ready == 0) {
+            errno = ETIMEDOUT;
+            return false;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// SOCK_SEQPACKET keeps message boundaries, so each batch is one packet. The
+// receiver listens; the sender retries connect() until the receiver is up.
+class UnixSeqpacketTransport : public Transport {
+public:
+    UnixSeqpacketTransport(TransportRole role, uint32_t partition)
+        : role_(role), path_(partitionedName(kSocketPath, partition)) {}
+
+    ~UnixSeqpacketTransport() override {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+        if (listenFd_ != -1) {
+            ::close(listenFd_);
+            ::unlink(path_.c_str());
+        }
+    }
+
+    bool open() {
+        struct sockaddr_un addr {};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            perror("socket");
+            return false;
+        }
+        int bufSize = static_cast<int>(4 * kMaxMsgPayload);
+        setsockopt(fd, SOL_SOCKET, role_ == TransportRole::Sender ? SO_SNDBUF : SO_RCVBUF, &bufSize,
+                   sizeof(bufSize));
+
+        if (role_ == TransportRole::Receiver) {
+            ::unlink(path_.c_str());
+            if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || listen(fd, 1) == -1) {
+                perror("bind/listen");
+                ::close(fd);
+                return false;
+            }
+            listenFd_ = fd;
+            return true;
+        }
+
+        constexpr int kConnectAttempts = 500;  // ~5 s for the receiver to come up
+        for (int attempt = 0; attempt < kConnectAttempts; ++attempt) {
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+                fd_ = fd;
+                return true;
+            }
+            if (errno != ENOENT && errno != ECONNREFUSED && errno != EINTR) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        perror("connect");
+        ::close(fd);
+        return false;
+    }
+
+    bool send(const unsigned char* data, size_t len) override {
+        while (::send(fd_, data, len, MSG_NOSIGNAL) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("send");
+            return false;
+        }
+        return true;
+    }
+
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        if (fd_ == -1) {
+            if (!waitReadable(listenFd_, timeout)) {
+                return errno == ETIMEDOUT ? RecvStatus::E_Timeout : RecvStatus::E_Error;
+            }
+            fd_ = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd_ == -1) {
+                perror("accept");
+                return RecvStatus::E_Error;
+            }
+        }
+        if (!waitReadable(fd_, timeout)) {
+            return errno == ETIMEDOUT ? RecvStatus::E_Timeout : RecvStatus::E_Error;
+        }
+        while (true) {
+            // A zero-length packet and a closed peer both read as 0: either way the stream is over.
+            ssize_t received = recv(fd_, buf, cap, 0);
+            if (received != -1) {
+                len = static_cast<size_t>(received);
+                return len == 0 ? RecvStatus::E_EndOfStream : RecvStatus::E_OK;
+            }
+            if (errno != EINTR) {
+                perror("recv");
+                return RecvStatus::E_Error;
+            }
+        }
+    }
+
+    size_t maxMessageSize() const override { return kMaxMsgPayload; }
+    const char* name() const override { return "socket"; }
+
+private:
+    TransportRole role_;
+    std::string path_;
+    int fd_ = -1;
+    int listenFd_ = -1;
+};
+
+// Named pipe carrying [uint32 length][payload] frames. The receiver opens the
+// FIFO read-write so it never sees EOF between writers; the sender's open
+// blocks until the receiver has the FIFO open.
+class FifoTransport : public Transport {
+public:
+    FifoTransport(TransportRole role, uint32_t partition)
+        : role_(role), path_(partitionedName(kFifoPath, partition)) {}
+
+    ~FifoTransport() override {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+        if (role_ == TransportRole::Receiver) {
+            ::unlink(path_.c_str());
+        }
+    }
+
+    bool open() {
+        if (mkfifo(path_.c_str(), 0666) == -1 && errno != EEXIST) {
+            perror("mkfifo");
+            return false;
+        }
+        fd_ = ::open(path_.c_str(), (role_ == TransportRole::Receiver ? O_RDWR : O_WRONLY) | O_CLOEXEC);
+        if (fd_ == -1) {
+            perror("open fifo");
+            return false;
+        }
+        if (role_ == TransportRole::Sender) {
+            fcntl(fd_, F_SETPIPE_SZ, static_cast<int>(4 * kMaxMsgPayload));
+        }
+        return true;
+    }
+
+    bool send(const unsigned char* data, size_t len) override {
+        uint32_t frameLen = static_cast<uint32_t>(len);
+        struct iovec iov[2] = {{&frameLen, sizeof(frameLen)}, {const_cast<unsigned char*>(data), len}};
+        size_t remaining = sizeof(frameLen) + len;
+        int iovIndex = 0;
+        while (remaining > 0) {
+            ssize_t written = writev(fd_, iov + iovIndex, 2 - iovIndex);
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("writev");
+                return false;
+            }
+            remaining -= static_cast<size_t>(written);
+            size_t consumed = static_cast<size_t>(written);
+            while (iovIndex < 2 && consumed >= iov[iovIndex].iov_len) {
+                consumed -= iov[iovIndex].iov_len;
+                ++iovIndex;
+            }
+            if (iovIndex < 2) {
+                iov[iovIndex].iov_base = static_cast<char*>(iov[iovIndex].iov_base) + consumed;
+                iov[iovIndex].iov_len -= consumed;
+            }
+        }
+        return true;
+    }
+
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        if (!waitReadable(fd_, timeout)) {
+            return errno == ETIMEDOUT ? RecvStatus::E_Timeout : RecvStatus::E_Error;
+        }
+        uint32_t frameLen = 0;
+        if (!readFully(reinterpret_cast<unsigned char*>(&frameLen), sizeof(frameLen))) {
+            return RecvStatus::E_Error;
+        }
+        if (frameLen > cap) {
+            std::cerr << "fifo frame of " << frameLen << " bytes exceeds buffer" << std::endl;
+            return RecvStatus::E_Error;
+        }
+        if (!readFully(buf, frameLen)) {
+            return RecvStatus::E_Error;
+        }
+        len = frameLen;
+        return len == 0 ? RecvStatus::E_EndOfStream : RecvStatus::E_OK;
+    }
+
+    size_t maxMessageSize() const override { return kMaxMsgPayload; }
+    const char* name() const override { return "pipe"; }
+
+private:
+    bool readFully(unsigned char* out, size_t len) {
+        while (len > 0) {
+            ssize_t got = read(fd_, out, len);
+            if (got > 0) {
+                out += got;
+                len -= static_cast<size_t>(got);
+                continue;
+            }
+            if (got == -1 && errno == EINTR) {
+                continue;
+            }
+            perror("read fifo");
+            return false;
+        }
+        return true;
+    }
+
+    TransportRole role_;
+    std::string path_;
+    int fd_ = -1;
+};
+
+}  // namespace
+
+const char* transportKindToString(TransportKind kind) {
+    switch (kind) {
+        case TransportKind::SysVQueue: return "sysv";
+        case TransportKind::SharedMemoryRing: return "shm";
+        case TransportKind::PosixMqueue: return "mqueue";
+        case TransportKind::UnixSeqpacket: return "socket";
+        case TransportKind::Pipe: return "pipe";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<Transport> makeTransport(TransportKind kind, TransportRole role, uint32_t partition,
+                                         const TransportTuning& tuning) {
+    switch (kind) {
+        case TransportKind::SysVQueue: {
+            auto transport = std::make_unique<SysVQueueTransport>(partition, tuning);
+            return transport->open() ? std::move(transport) : nullptr;
+        }
+        case TransportKind::SharedMemoryRing: {
+            auto transport = std::make_unique<ShmRingTransport>(role, partition);
+            return transport->open() ? std::move(transport) : nullptr;
+        }
+        case TransportKind::PosixMqueue: {
+            auto transport = std::make_unique<PosixMqueueTransport>(role, partition);
+            return transport->open() ? std::move(transport) : nullptr;
+        }
+        case TransportKind::UnixSeqpacket: {
+            auto transport = std::make_unique<UnixSeqpacketTransport>(role, partition);
+            return transport->open() ? std::move(transport) : nullptr;
+        }
+        case TransportKind::Pipe: {
+            auto transport = std::make_unique<FifoTransport>(role, partition);
+            return transport->open() ? std::move(transport) : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+bool parseTransportKind(std::string_view text, TransportKind& kind) {
+    if (text == "sysv") {
+        kind = TransportKind::SysVQueue;
+    } else if (text == "shm") {
+        kind = TransportKind::SharedMemoryRing;
+    } else if (text == "mqueue") {
+        kind = TransportKind::PosixMqueue;
+    } else if (text == "socket") {
+        kind = TransportKind::UnixSeqpacket;
+    } else if (text == "pipe") {
+        kind = TransportKind::Pipe;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool transportKindFromArgs(int argc, char** argv, TransportKind& kind) {
+    constexpr std::string_view kPrefix = "--transport=";
+    kind = TransportKind::SysVQueue;
+    if (const char* env = std::getenv("VEHICLE_TRANSPORT")) {
+        if (!parseTransportKind(env, kind)) {
+            std::cerr << "Unknown transport in VEHICLE_TRANSPORT: " << env << std::endl;
+            return false;
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, kPrefix.size()) == kPrefix) {
+            if (!parseTransportKind(arg.substr(kPrefix.size()), kind)) {
+                std::cerr << "Unknown transport: " << arg.substr(kPrefix.size()) << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool transportTuningFromArgs(int argc, char** argv, TransportTuning& tuning) {
+    constexpr std::string_view kPrefix = "--queue-bytes=";
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, kPrefix.size()) != kPrefix) {
+            continue;
+        }
+        std::string_view text = arg.substr(kPrefix.size());
+        size_t value = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        std::string_view suffix(result.ptr, static_cast<size_t>(text.data() + text.size() - result.ptr));
+        if (result.ec != std::errc() || value == 0 || suffix.size() > 1) {
+            std::cerr << "Invalid queue size: " << text << std::endl;
+            return false;
+        }
+        if (suffix == "k" || suffix == "K") {
+            value <<= 10;
+        } else if (suffix == "m" || suffix == "M") {
+            value <<= 20;
+        } else if (!suffix.empty()) {
+            std::cerr << "Invalid queue size: " << text << std::endl;
+            return false;
+        }
+        tuning.sysvQueueBytes = value;
+    }
+    return true;
+}
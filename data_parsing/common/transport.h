@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+enum class TransportKind : uint8_t {
+    SysVQueue = 0,
+    SharedMemoryRing,
+    PosixMqueue,
+    UnixSeqpacket,
+    Pipe,
+};
+
+constexpr TransportKind kAllTransportKinds[] = {
+    TransportKind::SysVQueue,   TransportKind::SharedMemoryRing, TransportKind::PosixMqueue,
+    TransportKind::UnixSeqpacket, TransportKind::Pipe,
+};
+
+enum class TransportRole : uint8_t {
+    Sender = 0,
+    Receiver,
+};
+
+enum class RecvStatus : uint8_t {
+    E_OK = 0,
+    E_EndOfStream,
+    E_Timeout,
+    E_Error,
+};
+
+// Pass as a receive() timeout to block until something arrives.
+constexpr std::chrono::milliseconds kWaitForever{-1};
+
+// Moves opaque message payloads (batches) from the sender to the receiver.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    // Blocks until the whole message is queued. len <= maxMessageSize(); a
+    // zero-length message is reserved for the end-of-stream marker.
+    virtual bool send(const unsigned char* data, size_t len) = 0;
+
+    // Sends a message the receiver takes ahead of anything sent with send()
+    // that it has not yet read. Transports without a priority mechanism fall
+    // back to FIFO order.
+    virtual bool sendPriority(const unsigned char* data, size_t len) { return send(data, len); }
+
+    // Tells the receiver no more messages follow. Transports without a native
+    // marker encode it as a zero-length message.
+    virtual bool sendEndOfStream() { return send(nullptr, 0); }
+
+    // Sleeps in the kernel (no polling) until a message arrives or timeout
+    // passes, then copies it into buf. timeout may be 0 (just check) or kWaitForever.
+    virtual RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) = 0;
+
+    virtual size_t maxMessageSize() const = 0;
+    virtual const char* name() const = 0;
+
+    // Transport-specific counters for the end-of-run summary; most have none.
+    virtual void printStats(std::ostream& os) const { (void)os; }
+};
+
+// Knobs that only some transports use; defaults leave the system alone.
+struct TransportTuning {
+    // SysV: msg_qbytes to set with msgctl(IPC_SET) at open; 0 keeps the
+    // queue's current limit (kernel.msgmnb for a new queue). Going above
+    // kernel.msgmnb needs CAP_SYS_RESOURCE.
+    size_t sysvQueueBytes = 0;
+};
+
+// Reads --queue-bytes=<n>[k|m]. Returns false on a malformed value.
+bool transportTuningFromArgs(int argc, char** argv, TransportTuning& tuning);
+
+// Returns nullptr (after reporting why) if the transport cannot be set up.
+// Each partition is an independent channel: its own mtypes on the shared SysV
+// queue, or its own ring/queue/socket/FIFO (name suffixed ".<partition>"
+// for partitions above 0) on the other transports.
+std::unique_ptr<Transport> makeTransport(TransportKind kind, TransportRole role, uint32_t partition = 0,
+                                         const TransportTuning& tuning = TransportTuning{});
+
+const char* transportKindToString(TransportKind kind);
+
+// Accepts "sysv", "shm", "mqueue", "socket" and "pipe".
+bool parseTransportKind(std::string_view text, TransportKind& kind);
+
+// Picks the transport from a "--transport=<name>" argument, else from the
+// VEHICLE_TRANSPORT environment variable, else the SysV queue. Returns false
+// on an unknown name. Both binaries must be given the same transport.
+bool transportKindFromArgs(int argc, char** argv, TransportKind& kind);
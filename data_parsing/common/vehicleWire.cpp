@@ -0,0 +1,78 @@
+#include "vehicleWire.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+static_assert(sizeof(double) == 8, "wire format expects 64-bit IEEE-754 doubles");
+
+template <typename T>
+inline void storeLE(unsigned char* out, T value) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "unsupported width");
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+#endif
+    std::memcpy(out, bytes, sizeof(T));
+}
+
+template <typename T>
+inline T loadLE(const unsigned char* in) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, in, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+#endif
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+}  // namespace
+
+size_t encodeRecord(const WireRecord& record, unsigned char* out, size_t cap) {
+    if (cap < kWireRecordSize) {
+        return 0;
+    }
+    out[0] = kWireVersion;
+    out[1] = record.engineOn ? kWireFlagEngineOn : 0;
+    out[2] = static_cast<unsigned char>(record.status);
+    out[3] = 0;
+    storeLE(out + 4, record.vehicleId);
+    storeLE(out + 8, record.timestampNs);
+    storeLE(out + 16, record.speed);
+    return kWireRecordSize;
+}
+
+bool decodeRecord(const unsigned char* in, size_t len, WireRecord& record) {
+    if (len < kWireRecordSize || in[0] != kWireVersion ||
+        in[2] > static_cast<unsigned char>(EngineStatus::E_Unknown)) {
+        return false;
+    }
+    record.engineOn = (in[1] & kWireFlagEngineOn) != 0;
+    record.status = static_cast<EngineStatus>(in[2]);
+    record.vehicleId = loadLE<int32_t>(in + 4);
+    record.timestampNs = loadLE<int64_t>(in + 8);
+    record.speed = loadLE<double>(in + 16);
+    return true;
+}
+
+void encodeBatchHeader(uint16_t count, unsigned char* out) {
+    out[0] = kBatchVersion;
+    out[1] = 0;
+    out[2] = static_cast<unsigned char>(count & 0xff);
+    out[3] = static_cast<unsigned char>(count >> 8);
+}
+
+bool decodeBatchHeader(const unsigned char* in, size_t len, uint16_t& count) {
+    if (len < kBatchHeaderSize || in[0] != kBatchVersion) {
+        return false;
+    }
+    count = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    return len == kBatchHeaderSize + static_cast<size_t>(count) * kWireRecordSize;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+
+constexpr key_t MSG_QUEUE_KEY = 0x2222;
+
+// SysV mtypes. Partition p sends fault batches as kMsgTypeFaults + 2p and
+// everything else as kMsgTypeRecords + 2p, so a lower type always means
+// more urgent. End of stream is a zero-length message of the records type.
+constexpr long kMsgTypeFaults = 1;
+constexpr long kMsgTypeRecords = 2;
+
+enum class EngineStatus : uint8_t {
+    OK = 0,
+    InvalidFormat,
+    E_SensorFailure,
+    E_Overheat,
+    E_Unknown,
+};
+
+// Statuses that are alarms rather than routine telemetry.
+inline bool isFaultStatus(EngineStatus status) {
+    return status == EngineStatus::E_Overheat || status == EngineStatus::E_SensorFailure;
+}
+
+// Decoded form of one vehicle record as it travels between sender and receiver.
+struct WireRecord {
+    int32_t vehicleId;
+    int64_t timestampNs;  // nanoseconds since the Unix epoch, UTC
+    double speed;
+    bool engineOn;
+    EngineStatus status;
+};
+
+// Fixed little-endian layout, version 1 (24 bytes):
+//   [0] version  [1] flags (bit0 = engine on)  [2] status  [3] reserved (0)
+//   [4..7] vehicleId (int32)  [8..15] timestampNs (int64)  [16..23] speed (IEEE-754 double)
+constexpr uint8_t kWireVersion = 1;
+constexpr size_t kWireRecordSize = 24;
+constexpr uint8_t kWireFlagEngineOn = 0x01;
+
+// Writes one record into out; returns bytes written, or 0 if cap is too small.
+size_t encodeRecord(const WireRecord& record, unsigned char* out, size_t cap);
+
+// Bounds-checked decode; rejects short input, unknown versions and out-of-range status.
+bool decodeRecord(const unsigned char* in, size_t len, WireRecord& record);
+
+// A message carries a batch: a 4-byte header followed by `count` records.
+//   [0] batch version  [1] flags (0 unless set by batchCodec.h)  [2..3] count (uint16)
+constexpr uint8_t kBatchVersion = 1;
+constexpr size_t kBatchHeaderSize = 4;
+
+// Upper bound on one message payload; the sender further caps it at the
+// kernel's msgmax (see /proc/sys/kernel/msgmax).
+constexpr size_t kMaxMsgPayload = 64 * 1024;
+
+void encodeBatchHeader(uint16_t count, unsigned char* out);
+
+// Validates the header and that len matches exactly `count` records.
+bool decodeBatchHeader(const unsigned char* in, size_t len, uint16_t& count);
+
+struct Msg {
+    long type;
+    unsigned char payload[kMaxMsgPayload];
+};
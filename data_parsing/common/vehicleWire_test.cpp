@@ -0,0 +1,76 @@
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "timestamp.h"
+#include "vehicleWire.h"
+
+int main() {
+    std::cout << "[Test] starting wire format tests\n";
+
+    // Test 1: timestamp parse/format round trip and validation.
+    {
+        int64_t ns = 0;
+        assert(parseTimestamp("1970-01-01 00:00:00", ns) && ns == 0);
+        assert(parseTimestamp("2026-02-14 10:15:23", ns) && ns == 1771064123LL * kNanosPerSecond);
+        char text[kTimestampTextLen + 1];
+        formatTimestamp(ns, text);
+        assert(std::string(text) == "2026-02-14 10:15:23");
+        assert(parseTimestamp("2024-02-29 23:59:59", ns));
+        assert(!parseTimestamp("2026-02-29 00:00:00", ns));  // not a leap year
+        assert(!parseTimestamp("2026-13-01 00:00:00", ns));
+        assert(!parseTimestamp("2026-02-14 24:00:00", ns));
+        assert(!parseTimestamp("2026-02-14T10:15:23", ns));
+        assert(!parseTimestamp("2026-02-14 10:15:2", ns));
+        assert(!parseTimestamp("INVALID_DATA", ns));
+        assert(parseTimestamp("1969-12-31 23:59:59", ns) && ns == -kNanosPerSecond);
+        formatTimestamp(ns, text);
+        assert(std::string(text) == "1969-12-31 23:59:59");
+        // Both ends of the int64 nanosecond range; one second further is rejected, not wrapped.
+        assert(parseTimestamp("2262-04-11 23:47:16", ns) && ns == 9223372036LL * kNanosPerSecond);
+        formatTimestamp(ns, text);
+        assert(std::string(text) == "2262-04-11 23:47:16");
+        assert(!parseTimestamp("2262-04-11 23:47:17", ns));
+        assert(parseTimestamp("1677-09-21 00:12:44", ns) && ns == -9223372036LL * kNanosPerSecond);
+        formatTimestamp(ns, text);
+        assert(std::string(text) == "1677-09-21 00:12:44");
+        assert(!parseTimestamp("1677-09-21 00:12:43", ns));
+        assert(!parseTimestamp("9999-12-31 23:59:59", ns));
+        assert(!parseTimestamp("0000-01-01 00:00:00", ns));
+        const int64_t minute = 60 * kNanosPerSecond;
+        assert(timestampWindowStart(1771064123LL * kNanosPerSecond, minute) == 1771064100LL * kNanosPerSecond);
+        assert(timestampWindowStart(-kNanosPerSecond, minute) == -minute);
+        assert(timestampWindowStart(0, minute) == 0);
+        std::cout << "[Test1] timestamps ok\n";
+    }
+
+    // Test 2: record encode/decode round trip keeps full precision.
+    {
+        WireRecord in{1001, 1771064123LL * kNanosPerSecond + 5, 88.123456789, true, EngineStatus::E_Overheat};
+        unsigned char buf[kWireRecordSize];
+        assert(encodeRecord(in, buf, sizeof(buf)) == kWireRecordSize);
+        assert(encodeRecord(in, buf, sizeof(buf) - 1) == 0);
+        WireRecord out{};
+        assert(decodeRecord(buf, sizeof(buf), out));
+        assert(out.vehicleId == in.vehicleId && out.timestampNs == in.timestampNs && out.speed == in.speed &&
+               out.engineOn == in.engineOn && out.status == in.status);
+        assert(!decodeRecord(buf, sizeof(buf) - 1, out));
+        buf[0] = kWireVersion + 1;
+        assert(!decodeRecord(buf, sizeof(buf), out));
+        std::cout << "[Test2] records ok\n";
+    }
+
+    // Test 3: batch header must match the payload length exactly.
+    {
+        unsigned char buf[kBatchHeaderSize + 2 * kWireRecordSize] = {};
+        encodeBatchHeader(2, buf);
+        uint16_t count = 0;
+        assert(decodeBatchHeader(buf, sizeof(buf), count) && count == 2);
+        assert(!decodeBatchHeader(buf, sizeof(buf) - 1, count));
+        assert(!decodeBatchHeader(buf, 2, count));
+        std::cout << "[Test3] batch header ok\n";
+    }
+
+    std::cout << "\n[Test] all wire format tests passed\n";
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "columnStore.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+VehicleColumnStore::LoadResult VehicleColumnStore::load(std::string_view contents, VehicleDataParser& parser,
+                                                        size_t threadCount) {
+    LoadResult result;
+    ParallelChunkParser chunks(parser, threadCount);
+    chunks.run(contents, [&](const ParsedChunk& chunk, size_t) {
+        appendChunk(chunk);
+        result.records += chunk.recordCount;
+        result.rejected += chunk.rejected.size();
+        return true;
+    });
+    shrinkToFit();
+    return result;
+}
+
+void VehicleColumnStore::append(const VehicleData& data) {
+    vehicleIds_.push_back(static_cast<int32_t>(data.vehicleId));
+    timestampsNs_.push_back(data.timestampNs);
+    speeds_.push_back(data.speed);
+    states_.push_back(packState(data.engineOn, data.errorCode));
+}
+
+void VehicleColumnStore::appendChunk(const ParsedChunk& chunk) {
+    // Transpose one column at a time so each destination is written sequentially.
+    const size_t base = size();
+    const size_t count = chunk.recordCount;
+    const VehicleData* records = chunk.records.data();
+    vehicleIds_.resize(base + count);
+    timestampsNs_.resize(base + count);
+    speeds_.resize(base + count);
+    states_.resize(base + count);
+    for (size_t i = 0; i < count; ++i) {
+        vehicleIds_[base + i] = static_cast<int32_t>(records[i].vehicleId);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        timestampsNs_[base + i] = records[i].timestampNs;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        speeds_[base + i] = records[i].speed;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        states_[base + i] = packState(records[i].engineOn, records[i].errorCode);
+    }
+}
+
+void VehicleColumnStore::reserve(size_t rows) {
+    vehicleIds_.reserve(rows);
+    timestampsNs_.reserve(rows);
+    speeds_.reserve(rows);
+    states_.reserve(rows);
+}
+
+void VehicleColumnStore::shrinkToFit() {
+    vehicleIds_.shrink_to_fit();
+    timestampsNs_.shrink_to_fit();
+    speeds_.shrink_to_fit();
+    states_.shrink_to_fit();
+}
+
+void VehicleColumnStore::clear() {
+    vehicleIds_.clear();
+    timestampsNs_.clear();
+    speeds_.clear();
+    states_.clear();
+}
+
+size_t VehicleColumnStore::memoryBytes() const {
+    return vehicleIds_.capacity() * sizeof(int32_t) + timestampsNs_.capacity() * sizeof(int64_t) +
+           speeds_.capacity() * sizeof(double) + states_.capacity();
+}
+
+VehicleData VehicleColumnStore::row(size_t index) const {
+    return VehicleData{vehicleIds_[index], timestampsNs_[index], speeds_[index], stateEngineOn(states_[index]),
+                       stateStatus(states_[index])};
+}
+
+size_t VehicleColumnStore::countStatus(EngineStatus status) const {
+    const uint8_t wanted = static_cast<uint8_t>(status);
+    const uint8_t* column = states_.data();
+    const size_t rows = states_.size();
+    // Branch-free so the compiler can turn this into byte compares + horizontal adds.
+    size_t count = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        count += (column[i] & kStatusMask) == wanted;
+    }
+    return count;
+}
+
+size_t VehicleColumnStore::filterByStatus(EngineStatus status, std::vector<uint32_t>& rows) const {
+    const uint8_t wanted = static_cast<uint8_t>(status);
+    const uint8_t* column = states_.data();
+    const size_t total = states_.size();
+    // Size once from the counting pass, then compact without branches: every
+    // index is stored and the cursor only advances on a match.
+    rows.resize(countStatus(status) + 1);
+    uint32_t* out = rows.data();
+    size_t matched = 0;
+    for (size_t i = 0; i < total; ++i) {
+        out[matched] = static_cast<uint32_t>(i);
+        matched += (column[i] & kStatusMask) == wanted;
+    }
+    rows.resize(matched);
+    return matched;
+}
+
+std::vector<uint64_t> VehicleColumnStore::speedHistogram(double lo, double hi, size_t bucketCount) const {
+    std::vector<uint64_t> buckets(bucketCount, 0);
+    if (bucketCount == 0 || !(hi > lo)) {
+        return buckets;
+    }
+    const double scale = bucketCount / (hi - lo);
+    const double last = static_cast<double>(bucketCount - 1);
+    const double* column = speeds_.data();
+    const size_t rows = speeds_.size();
+    for (size_t i = 0; i < rows; ++i) {
+        double slot = std::min(std::max((column[i] - lo) * scale, 0.0), last);
+        ++buckets[static_cast<size_t>(slot)];
+    }
+    return buckets;
+}
+
+std::vector<std::pair<int32_t, double>> VehicleColumnStore::maxSpeedPerVehicle() const {
+    std::vector<std::pair<int32_t, double>> result;
+    const size_t rows = size();
+    if (rows == 0) {
+        return result;
+    }
+    const int32_t* ids = vehicleIds_.data();
+    const double* speeds = speeds_.data();
+    const auto [lowest, highest] = std::minmax_element(ids, ids + rows);
+    const int32_t base = *lowest;
+    const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(*highest) - base) + 1;
+
+    if (span <= 2 * rows + 1024) {
+        // One slot per id in range; rows only ever touch their own slot.
+        std::vector<double> best(span);
+        std::vector<uint8_t> seen(span, 0);
+        for (size_t i = 0; i < rows; ++i) {
+            const size_t slot = static_cast<size_t>(ids[i] - base);
+            best[slot] = seen[slot] ? std::max(best[slot], speeds[i]) : speeds[i];
+            seen[slot] = 1;
+        }
+        for (size_t slot = 0; slot < span; ++slot) {
+            if (seen[slot]) {
+                result.emplace_back(static_cast<int32_t>(base + static_cast<int64_t>(slot)), best[slot]);
+            }
+        }
+        return result;
+    }
+
+    std::unordered_map<int32_t, double> best;
+    for (size_t i = 0; i < rows; ++i) {
+        auto [it, inserted] = best.try_emplace(ids[i], speeds[i]);
+        if (!inserted) {
+            it->second = std::max(it->second, speeds[i]);
+        }
+    }
+    result.assign(best.begin(), best.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,108 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "columnStore.h"
+#include "../common/timestamp.h"
+
+int main() {
+    std::cout << "[Test] starting column store tests\n";
+
+    // Ten vehicles cycling; every 5th record overheats, every 13th line is malformed.
+    std::string buf;
+    std::vector<VehicleData> expected;
+    for (int i = 1; i <= 5000; ++i) {
+        if (i % 13 == 0) {
+            buf += "BROKEN\n";
+            continue;
+        }
+        VehicleData d{1000 + i % 10, 0, static_cast<double>(i % 150), i % 2 == 0,
+                      i % 5 == 0 ? EngineStatus::E_Overheat : EngineStatus::OK};
+        buf += std::to_string(d.vehicleId) + ",2026-02-14 10:15:23," + std::to_string(i % 150) + "," +
+               (d.engineOn ? "1" : "0") + "," + (i % 5 == 0 ? "ENGINE_OVERHEAT" : "ENGINE_OK") + "\n";
+        parseTimestamp("2026-02-14 10:15:23", d.timestampNs);
+        expected.push_back(d);
+    }
+
+    // Test 1: chunked load keeps file order and every column matches.
+    VehicleColumnStore store;
+    VehicleDataParser parser;
+    auto loaded = store.load(buf, parser, 2);
+    assert(loaded.records == expected.size());
+    assert(loaded.rejected == 5000 / 13);
+    assert(store.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        VehicleData r = store.row(i);
+        assert(r.vehicleId == expected[i].vehicleId && r.timestampNs == expected[i].timestampNs &&
+               r.speed == expected[i].speed && r.engineOn == expected[i].engineOn &&
+               r.errorCode == expected[i].errorCode);
+    }
+    std::cout << "[Test1] load ok, " << store.memoryBytes() << " bytes for " << store.size() << " rows\n";
+
+    // Test 2: status filter returns exactly the matching rows in order.
+    std::vector<uint32_t> rows;
+    size_t overheats = store.filterByStatus(EngineStatus::E_Overheat, rows);
+    assert(overheats == store.countStatus(EngineStatus::E_Overheat) && overheats == rows.size());
+    size_t next = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].errorCode == EngineStatus::E_Overheat) {
+            assert(rows[next++] == i);
+        }
+    }
+    assert(next == overheats);
+    assert(store.filterByStatus(EngineStatus::E_Unknown, rows) == 0 && rows.empty());
+    std::cout << "[Test2] filterByStatus ok\n";
+
+    // Test 3: histogram covers every row; out-of-range speeds clamp to the ends.
+    auto hist = store.speedHistogram(10.0, 110.0, 10);
+    uint64_t total = 0;
+    for (uint64_t c : hist) { total += c; }
+    assert(total == store.size());
+    size_t low = 0;
+    for (const auto& d : expected) { low += d.speed < 20.0; }
+    assert(hist[0] == low);
+    std::cout << "[Test3] speedHistogram ok\n";
+
+    // Test 4: per-vehicle max matches a naive scan.
+    auto maxes = store.maxSpeedPerVehicle();
+    assert(maxes.size() == 10);
+    for (const auto& [id, best] : maxes) {
+        double want = -1.0;
+        for (const auto& d : expected) {
+            if (d.vehicleId == id && d.speed > want) { want = d.speed; }
+        }
+        assert(best == want);
+    }
+    // Sparse ids take the hash map path and still come back sorted.
+    VehicleColumnStore sparse;
+    sparse.append(VehicleData{2000000000, 0, 12.5, true, EngineStatus::OK});
+    sparse.append(VehicleData{-7, 0, 40.25, true, EngineStatus::OK});
+    sparse.append(VehicleData{2000000000, 0, 99.75, true, EngineStatus::OK});
+    sparse.append(VehicleData{-7, 0, 3.0, true, EngineStatus::OK});
+    auto sparseMaxes = sparse.maxSpeedPerVehicle();
+    assert(sparseMaxes.size() == 2);
+    assert(sparseMaxes[0].first == -7 && sparseMaxes[0].second == 40.25);
+    assert(sparseMaxes[1].first == 2000000000 && sparseMaxes[1].second == 99.75);
+    std::cout << "[Test4] maxSpeedPerVehicle ok\n";
+
+    // Test 5: engine flag and status share a byte; a row is 21 bytes and
+    // gives back exactly the speed it was given.
+    {
+        VehicleColumnStore packed;
+        packed.reserve(4);
+        packed.append(VehicleData{1, 0, 88.5, false, EngineStatus::E_Unknown});
+        packed.append(VehicleData{2, 0, 0.0, true, EngineStatus::E_SensorFailure});
+        packed.append(VehicleData{3, 0, 92.3, true, EngineStatus::OK});
+        packed.append(VehicleData{4, 0, 1e300, true, EngineStatus::OK});
+        assert(!packed.row(0).engineOn && packed.row(0).errorCode == EngineStatus::E_Unknown);
+        assert(packed.row(1).engineOn && packed.row(1).errorCode == EngineStatus::E_SensorFailure);
+        assert(packed.countStatus(EngineStatus::E_SensorFailure) == 1);
+        assert(packed.row(2).speed == 92.3 && packed.row(3).speed == 1e300);
+        assert(packed.maxSpeedPerVehicle()[3].second == 1e300);
+        assert(packed.memoryBytes() == 4 * 21);
+        std::cout << "[Test5] packed state ok\n";
+    }
+
+    std::cout << "[Test] all column store tests passed\n";
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "fieldScanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIELD_SCANNER_X86 1
+#endif
+
+namespace {
+
+inline void emitMask(uint64_t mask, uint32_t base, std::vector<uint32_t>& offsets) {
+    while (mask != 0) {
+        offsets.push_back(base + static_cast<uint32_t>(__builtin_ctzll(mask)));
+        mask &= mask - 1;
+    }
+}
+
+void scanScalar(const char* data, size_t begin, size_t len, std::vector<uint32_t>& offsets) {
+    for (size_t i = begin; i < len; ++i) {
+        if (data[i] == ',' || data[i] == '\n') {
+            offsets.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+#if defined(FIELD_SCANNER_X86) && defined(__SSE2__)
+size_t scanSse2(const char* data, size_t len, std::vector<uint32_t>& offsets) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        uint64_t mask = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lane * 16));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline));
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hits))) << (lane * 16);
+        }
+        emitMask(mask, static_cast<uint32_t>(i), offsets);
+    }
+    return i;
+}
+#endif
+
+#if defined(FIELD_SCANNER_X86)
+__attribute__((target("avx2")))
+size_t scanAvx2(const char* data, size_t len, std::vector<uint32_t>& offsets) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i hitsLo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline));
+        __m256i hitsHi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hitsLo))
+                      | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hitsHi))) << 32);
+        emitMask(mask, static_cast<uint32_t>(i), offsets);
+    }
+    return i;
+}
+#endif
+
+}  // namespace
+
+ScanIsa detectScanIsa() {
+#if defined(FIELD_SCANNER_X86)
+    static const ScanIsa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return ScanIsa::AVX2;
+        }
+#if defined(__SSE2__)
+        return ScanIsa::SSE2;
+#else
+        return ScanIsa::Scalar;
+#endif
+    }();
+    return isa;
+#else
+    return ScanIsa::Scalar;
+#endif
+}
+
+const char* scanIsaToString(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::Scalar: return "scalar";
+        case ScanIsa::SSE2: return "sse2";
+        case ScanIsa::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+void scanSeparators(std::string_view buf, std::vector<uint32_t>& offsets) {
+    scanSeparators(buf, offsets, detectScanIsa());
+}
+
+void scanSeparators(std::string_view buf, std::vector<uint32_t>& offsets, ScanIsa isa) {
+    const char* data = buf.data();
+    size_t len = buf.size();
+    size_t done = 0;
+    // Never run a path the CPU cannot execute, even if the caller asked for it.
+    if (isa > detectScanIsa()) {
+        isa = detectScanIsa();
+    }
+    switch (isa) {
+#if defined(FIELD_SCANNER_X86)
+        case ScanIsa::AVX2:
+            done = scanAvx2(data, len, offsets);
+            break;
+#endif
+#if defined(FIELD_SCANNER_X86) && defined(__SSE2__)
+        case ScanIsa::SSE2:
+            done = scanSse2(data, len, offsets);
+            break;
+#endif
+        default:
+            break;
+    }
+    scanScalar(data, done, len, offsets);
+}
+
+bool LineFieldIterator::next(std::string_view& line, std::string_view* fields, size_t maxFields, size_t& fieldCount) {
+    if (lineStart_ >= buf_.size()) {
+        return false;
+    }
+    fieldCount = 0;
+    size_t fieldStart = lineStart_;
+    size_t lineEnd = buf_.size();
+    size_t nextLine = buf_.size();
+    while (sepIndex_ < offsets_.size()) {
+        size_t sep = offsets_[sepIndex_++];
+        if (fieldCount < maxFields) {
+            fields[fieldCount] = buf_.substr(fieldStart, sep - fieldStart);
+        }
+        ++fieldCount;
+        fieldStart = sep + 1;
+        if (buf_[sep] == '\n') {
+            lineEnd = sep;
+            nextLine = sep + 1;
+            break;
+        }
+    }
+    if (lineEnd == buf_.size()) {
+        // Final line with no trailing newline.
+        if (fieldCount < maxFields) {
+            fields[fieldCount] = buf_.substr(fieldStart);
+        }
+        ++fieldCount;
+    }
+
+    line = buf_.substr(lineStart_, lineEnd - lineStart_);
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+        size_t last = fieldCount - 1;
+        if (last < maxFields && !fields[last].empty()) {
+            fields[last].remove_suffix(1);
+        }
+    }
+    lineStart_ = nextLine;
+    return true;
+}
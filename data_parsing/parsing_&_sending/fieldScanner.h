@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Instruction set used by scanSeparators(). Scalar is always available.
+enum class ScanIsa : uint8_t {
+    Scalar = 0,
+    SSE2,
+    AVX2,
+};
+
+// Best instruction set supported by the running CPU (checked once).
+ScanIsa detectScanIsa();
+const char* scanIsaToString(ScanIsa isa);
+
+// Appends the offset of every ',' and '\n' in buf to offsets, in order.
+// Offsets are 32-bit, so callers split inputs larger than 4 GiB into chunks.
+void scanSeparators(std::string_view buf, std::vector<uint32_t>& offsets);
+void scanSeparators(std::string_view buf, std::vector<uint32_t>& offsets, ScanIsa isa);
+
+// Walks a buffer scanned by scanSeparators() one line at a time, handing out
+// field views without touching the bytes again. A final line without a
+// trailing newline is still returned, and a trailing '\r' is dropped.
+class LineFieldIterator {
+public:
+    LineFieldIterator(std::string_view buf, const std::vector<uint32_t>& offsets)
+        : buf_(buf), offsets_(offsets) {}
+
+    // Returns false once the buffer is exhausted. fieldCount is the real number
+    // of fields on the line; only the first maxFields views are filled in.
+    bool next(std::string_view& line, std::string_view* fields, size_t maxFields, size_t& fieldCount);
+
+private:
+    std::string_view buf_;
+    const std::vector<uint32_t>& offsets_;
+    size_t lineStart_ = 0;
+    size_t sepIndex_ = 0;
+};
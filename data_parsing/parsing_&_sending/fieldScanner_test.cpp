@@ -0,0 +1,91 @@
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "fieldScanner.h"
+#include "string_parsing.h"
+
+namespace {
+
+bool sameRecord(const VehicleData& a, const VehicleData& b) {
+    return a.vehicleId == b.vehicleId && a.timestampNs == b.timestampNs && a.speed == b.speed &&
+           a.engineOn == b.engineOn && a.errorCode == b.errorCode;
+}
+
+std::string randomBuffer(std::mt19937& rng, size_t len) {
+    static const char alphabet[] = ",\n\r0123456789.ABCDEFGHIJKLMNOPQRSTUVWXYZ_ -:";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+    std::string out(len, ' ');
+    for (auto& c : out) { c = alphabet[pick(rng)]; }
+    return out;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "[Test] starting field scanner tests, best isa=" << scanIsaToString(detectScanIsa()) << "\n";
+
+    // Test 1: every ISA finds the same separators as the scalar scan.
+    {
+        std::cout << "\n[Test1] scanner differential on random buffers\n";
+        std::mt19937 rng(1234);
+        for (size_t len = 0; len < 300; ++len) {
+            std::string buf = randomBuffer(rng, len);
+            std::vector<uint32_t> expected;
+            scanSeparators(buf, expected, ScanIsa::Scalar);
+            for (ScanIsa isa : {ScanIsa::SSE2, ScanIsa::AVX2}) {
+                std::vector<uint32_t> got;
+                scanSeparators(buf, got, isa);
+                assert(got == expected);
+            }
+        }
+        std::cout << "[Test1] ok\n";
+    }
+
+    // Test 2: decoding through the separator index matches parseLine() line by line.
+    {
+        std::cout << "\n[Test2] indexed decode matches parseLine\n";
+        std::string buf =
+            "1001,2026-02-14 10:15:23,88.5,1,ENGINE_OK\n"
+            "1002,2026-02-14 10:16:10,92.3,0,ENGINE_OVERHEAT\r\n"
+            "\n"
+            "1011,INVALID_DATA\n"
+            "1012,2026-02-14 10:24:55,abc,1,ENGINE_OK\n"
+            ",2026-02-14 10:25:12,77.3,1,ENGINE_OK\n"
+            "1013,2026-02-14 10:26:30,98.2,2,ENGINE_OK\n"
+            "1014,2026-02-14 10:26:30,98.2,1,ENGINE_OK,extra\n"
+            "1005,2026-02-14 10:18:22,85.0,0,ENGINE_SENSOR_FAIL";  // no trailing newline
+        auto parser = VehicleDataParser::getInstance();
+
+        std::vector<uint32_t> offsets;
+        scanSeparators(buf, offsets);
+        LineFieldIterator it(buf, offsets);
+
+        std::istringstream lines(buf);
+        std::string expectedLine;
+        std::string_view line;
+        std::string_view fields[5];
+        size_t fieldCount = 0;
+        size_t lineCount = 0;
+        while (std::getline(lines, expectedLine)) {
+            assert(it.next(line, fields, 5, fieldCount));
+            ++lineCount;
+            if (!expectedLine.empty() && expectedLine.back() == '\r') { expectedLine.pop_back(); }
+            assert(line == expectedLine);
+            if (line.empty()) { continue; }
+            VehicleData viaLine{};
+            VehicleData viaIndex{};
+            ParseStatus a = parser->parseLine(expectedLine, viaLine);
+            ParseStatus b = parser->decodeFields(fields, fieldCount, viaIndex);
+            assert(a == b);
+            assert(a != ParseStatus::E_OK || sameRecord(viaLine, viaIndex));
+        }
+        assert(!it.next(line, fields, 5, fieldCount));
+        std::cout << "[Test2] ok lines=" << lineCount << "\n";
+    }
+
+    std::cout << "\n[Test] all field scanner tests passed\n";
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "fileFollower.h"
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FileFollower::~FileFollower() {
+    if (fd_ != -1) {
+        ::close(fd_);
+    }
+    if (inotifyFd_ != -1) {
+        ::close(inotifyFd_);
+    }
+}
+
+bool FileFollower::start(const std::string& path, uint64_t offset) {
+    path_ = path;
+    size_t slash = path.rfind('/');
+    dirName_ = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+    baseName_ = slash == std::string::npos ? path : path.substr(slash + 1);
+    offset_ = offset;
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ == -1) {
+        perror("inotify_init1");
+        return false;
+    }
+    // The directory watch catches the replacement file appearing after a rotation.
+    dirWatch_ = inotify_add_watch(inotifyFd_, dirName_.c_str(), IN_CREATE | IN_MOVED_TO);
+    if (dirWatch_ == -1) {
+        perror("inotify_add_watch");
+        return false;
+    }
+    return openFile();
+}
+
+bool FileFollower::openFile() {
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+        if (errno == ENOENT) {
+            return true;  // rotated away and not recreated yet; the dir watch will tell us
+        }
+        perror("open");
+        return false;
+    }
+    fileWatch_ = inotify_add_watch(inotifyFd_, path_.c_str(), IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF);
+    if (fileWatch_ == -1) {
+        perror("inotify_add_watch");
+        return false;
+    }
+    return true;
+}
+
+bool FileFollower::readAppended() {
+    if (fd_ == -1) {
+        return true;
+    }
+    struct stat st {};
+    if (fstat(fd_, &st) == -1) {
+        perror("fstat");
+        return false;
+    }
+    if (static_cast<uint64_t>(st.st_size) < offset_) {
+        // Truncated in place (copytruncate): start over from the top.
+        offset_ = 0;
+        dropPartialLine();
+        ++rotations_;
+    }
+    backlog_ = false;
+    for (size_t blocks = 0;; ++blocks) {
+        if (blocks == kReadBlocksPerPoll) {
+            backlog_ = true;
+            return true;
+        }
+        size_t used = pending_.size();
+        pending_.resize(used + kReadBlock);
+        ssize_t got = pread(fd_, &pending_[used], kReadBlock, static_cast<off_t>(offset_));
+        if (got == -1 && errno == EINTR) {
+            pending_.resize(used);
+            --blocks;
+            continue;
+        }
+        if (got <= 0) {
+            pending_.resize(used);
+            if (got == -1) {
+                perror("pread");
+                return false;
+            }
+            return true;
+        }
+        pending_.resize(used + static_cast<size_t>(got));
+        offset_ += static_cast<uint64_t>(got);
+    }
+}
+
+void FileFollower::dropPartialLine() {
+    // Whatever follows the last newline will never be completed.
+    size_t lineStart = pending_.rfind('\n');
+    lineStart = lineStart == std::string::npos ? 0 : lineStart + 1;
+    truncated_.assign(pending_, lineStart, std::string::npos);
+    pending_.resize(lineStart);
+}
+
+bool FileFollower::handleEvents() {
+    alignas(struct inotify_event) char buf[64 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    while (true) {
+        ssize_t len = read(inotifyFd_, buf, sizeof(buf));
+        if (len == -1) {
+            if (errno == EAGAIN) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("read inotify");
+            return false;
+        }
+        for (char* p = buf; p < buf + len;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(p);
+            if (event->wd == fileWatch_ && (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF))) {
+                rotated_ = true;
+            } else if (event->wd == dirWatch_ && event->len > 0 && baseName_ == event->name) {
+                rotated_ = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+FollowStatus FileFollower::poll(std::chrono::milliseconds timeout, std::string& completeLines) {
+    completeLines.clear();
+    truncated_.clear();
+    struct pollfd pfd {inotifyFd_, POLLIN, 0};
+    int ready = ::poll(&pfd, 1, backlog_ ? 0 : static_cast<int>(timeout.count()));
+    if (ready == -1) {
+        if (errno == EINTR) {
+            return FollowStatus::E_Interrupted;
+        }
+        perror("poll");
+        return FollowStatus::E_Error;
+    }
+
+    if (ready > 0 && !handleEvents()) {
+        return FollowStatus::E_Error;
+    }
+    // Always read: it is cheap and also covers appends made before the watch existed.
+    if (!readAppended()) {
+        return FollowStatus::E_Error;
+    }
+    // A writer may still append to the renamed file until it reopens the path,
+    // so keep draining the old file until its replacement actually exists.
+    // The old file's last whole lines go out first; the switch waits for the
+    // next poll, which then does not wait.
+    const bool oldLinesPending = pending_.find('\n') != std::string::npos;
+    if (rotated_ && (backlog_ || oldLinesPending)) {
+        backlog_ = true;
+    } else if (rotated_ && (fd_ == -1 || ::access(path_.c_str(), F_OK) == 0)) {
+        // Everything still in the old file has been read above; switch to the new one.
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+            inotify_rm_watch(inotifyFd_, fileWatch_);
+            fileWatch_ = -1;
+        }
+        dropPartialLine();
+        rotated_ = false;
+        offset_ = 0;
+        ++rotations_;
+        if (!openFile() || !readAppended()) {
+            return FollowStatus::E_Error;
+        }
+    }
+
+    size_t lastNewline = pending_.rfind('\n');
+    if (lastNewline == std::string::npos) {
+        return FollowStatus::E_Idle;
+    }
+    // Hand the buffer over and keep only the partial tail, so a burst is not
+    // held twice.
+    completeLines.swap(pending_);
+    pending_.assign(completeLines, lastNewline + 1, std::string::npos);
+    completeLines.resize(lastNewline + 1);
+    return FollowStatus::E_Data;
+}
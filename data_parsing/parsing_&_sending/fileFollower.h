@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class FollowStatus : uint8_t {
+    E_Data = 0,     // completeLines holds new lines
+    E_Idle,         // nothing new before the timeout
+    E_Interrupted,  // a signal arrived while waiting
+    E_Error,
+};
+
+// Tails a growing file with inotify, like `tail -F`. Only whole lines are
+// handed out; a trailing partial line is held back until its newline
+// arrives. On rotation (the path renamed or deleted, then recreated) the old
+// file is drained until the new one appears, then following restarts at
+// offset 0 of the new file; in-place truncation also restarts at 0. A
+// partial line left behind by either is never completed and is handed out
+// separately as truncatedLine(). No byte is delivered twice.
+//
+// Each poll() reads at most kReadBlocksPerPoll blocks, so a large burst is
+// handed out in bounded batches; the next poll() continues without waiting.
+class FileFollower {
+public:
+    static constexpr size_t kReadBlock = 1 << 20;
+    static constexpr size_t kReadBlocksPerPoll = 16;
+
+    FileFollower() = default;
+    ~FileFollower();
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    // Starts following path from byte offset (bytes before it were already consumed).
+    bool start(const std::string& path, uint64_t offset);
+
+    // Waits up to timeout for the file to change (not at all while a burst is
+    // still being read), then reads what is new. completeLines is overwritten
+    // with zero or more '\n'-terminated lines.
+    FollowStatus poll(std::chrono::milliseconds timeout, std::string& completeLines);
+    // The unterminated end of a rotated or truncated file, without a '\n', if
+    // the last poll() found one. It precedes that poll's completeLines.
+    const std::string& truncatedLine() const { return truncated_; }
+
+    uint64_t offset() const { return offset_; }
+    size_t rotations() const { return rotations_; }
+
+private:
+    bool openFile();
+    bool readAppended();
+    bool handleEvents();
+    void dropPartialLine();
+
+    std::string path_;
+    std::string dirName_;
+    std::string baseName_;
+    int inotifyFd_ = -1;
+    int fileWatch_ = -1;
+    int dirWatch_ = -1;
+    int fd_ = -1;
+    uint64_t offset_ = 0;
+    size_t rotations_ = 0;
+    bool rotated_ = false;  // a replacement file exists or is expected
+    bool backlog_ = false;  // more to do without waiting for an event
+    std::string pending_;   // bytes read but not yet handed out
+    std::string truncated_;
+};
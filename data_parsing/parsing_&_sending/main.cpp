@@ -1,15 +1,55 @@
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+#include "quarantine.h"
 #include "string_parsing.h"
 
-int main() {
-    auto instance = VehicleDataParser::getInstance();
-    try {
-        if(instance == nullptr) {
-            std::cerr << "Failed to create VehicleDataParser instance" << std::endl;
+int main(int argc, char** argv) {
+    TransportKind kind;
+    OutputOptions outputOptions;
+    BatchEncoding encoding;
+    TransportTuning tuning;
+    uint32_t partitions = 1;
+    if (!transportKindFromArgs(argc, argv, kind) || !outputOptionsFromArgs(argc, argv, outputOptions) ||
+        !batchEncodingFromArgs(argc, argv, encoding) || !partitionCountFromArgs(argc, argv, partitions) ||
+        !transportTuningFromArgs(argc, argv, tuning)) {
+        return 1;
+    }
+    OutputWriter out(STDOUT_FILENO, outputOptions);
+    bool follow = false;
+    bool prioritizeFaults = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg == "--follow") {
+            follow = true;
+        } else if (arg == "--fault-priority=off") {
+            prioritizeFaults = false;
+        }
+    }
+    std::vector<std::unique_ptr<Transport>> transports;
+    for (uint32_t partition = 0; partition < partitions; ++partition) {
+        transports.push_back(makeTransport(kind, TransportRole::Sender, partition, tuning));
+        if (transports.back() == nullptr) {
+            std::cerr << "Failed to open transport for partition " << partition << std::endl;
             return 1;
         }
-        
-        if(instance->parseAndSend() != sendStatus::E_OK) {
+    }
+    PartitionRouter router(std::move(transports), encoding, prioritizeFaults);
+
+    std::string quarantinePath;
+    quarantinePathFromArgs(argc, argv, quarantinePath);
+    QuarantineSink quarantine(std::cerr);
+    if (!quarantinePath.empty() && !quarantine.open(quarantinePath)) {
+        return 1;
+    }
+
+    VehicleDataParser parser;
+    parser.setQuarantine(&quarantine);
+    try {
+        if(parser.parseAndSend(router, out, follow) != sendStatus::E_OK) {
             std::cerr << "Failed to parse and send vehicle data" << std::endl;
             return 1;
         }
@@ -0,0 +1,87 @@
+#include "mappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = std::exchange(other.fd_, -1);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        perror("open");
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == -1) {
+        perror("fstat");
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        // mmap rejects zero-length mappings; an empty view is the right answer.
+        return true;
+    }
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        perror("mmap");
+        close();
+        return false;
+    }
+    data_ = static_cast<const char*>(addr);
+    if (madvise(addr, size_, MADV_SEQUENTIAL) == -1) {
+        perror("madvise");  // only a hint, keep going
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+std::string_view nextLineChunk(std::string_view data, size_t& pos, size_t targetSize) {
+    if (pos >= data.size()) {
+        return {};
+    }
+    size_t start = pos;
+    size_t end = data.size();
+    if (data.size() - start > targetSize) {
+        const void* nl = std::memchr(data.data() + start + targetSize, '\n', data.size() - start - targetSize);
+        if (nl != nullptr) {
+            end = static_cast<size_t>(static_cast<const char*>(nl) - data.data()) + 1;
+        }
+    }
+    pos = end;
+    return data.substr(start, end - start);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only mmap of a whole file. Views handed out point straight into the
+// mapping and stay valid until the MappedFile is closed or destroyed.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Maps path and advises the kernel of sequential access. An empty file
+    // opens successfully with an empty view. Failures are reported via perror.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return fd_ != -1; }
+    std::string_view view() const { return {data_, size_}; }
+
+private:
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Returns the next slice of data starting at pos that is at least targetSize
+// bytes (unless the data ends first) and ends just after a '\n' or at the end
+// of data, then advances pos past it. Returns an empty view once pos reaches the end.
+std::string_view nextLineChunk(std::string_view data, size_t& pos, size_t targetSize);
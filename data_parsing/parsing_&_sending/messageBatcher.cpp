@@ -0,0 +1,142 @@
+#include "messageBatcher.h"
+#include <algorithm>
+#include <iostream>
+
+MessageBatcher::MessageBatcher(Transport& transport, std::chrono::microseconds flushInterval, BatchEncoding encoding,
+                               bool prioritizeFaults)
+    : transport_(transport), flushInterval_(flushInterval), encoding_(encoding), prioritizeFaults_(prioritizeFaults) {
+    // Leave room for the queued-time trailer on every message.
+    payloadLimit_ = std::min(transport_.maxMessageSize(), kMaxMsgPayload) - kBatchTrailerSize;
+    faultPayload_.resize(kBatchHeaderSize + kWireRecordSize + kBatchTrailerSize);
+    if (encoding_ == BatchEncoding::Delta) {
+        // The header count field is the only record limit; bytes decide the rest.
+        maxRecords_ = UINT16_MAX;
+        payload_.resize(payloadLimit_ + kBatchTrailerSize);
+        return;
+    }
+    maxRecords_ = payloadLimit_ > kBatchHeaderSize ? (payloadLimit_ - kBatchHeaderSize) / kWireRecordSize : 0;
+    maxRecords_ = std::clamp<size_t>(maxRecords_, 1, UINT16_MAX);
+    payload_.resize(kBatchHeaderSize + maxRecords_ * kWireRecordSize + kBatchTrailerSize);
+}
+
+int64_t MessageBatcher::monotonicNs(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+void MessageBatcher::notePending() {
+    if (pending_ == 0) {
+        oldestPending_ = Clock::now();
+    }
+    ++pending_;
+}
+
+// Shared by batches and faults, so the message rate covers every send.
+void MessageBatcher::noteSent(size_t records, size_t bytes) {
+    lastSend_ = Clock::now();
+    if (messagesSent_ == 0) {
+        firstSend_ = lastSend_;
+    }
+    ++messagesSent_;
+    recordsSent_ += records;
+    bytesSent_ += bytes;
+}
+
+bool MessageBatcher::sendFault(const WireRecord& record) {
+    // One record in the fixed layout: a fault is rare, and encoding it alone
+    // costs less than holding it for a batch.
+    encodeBatchHeader(1, faultPayload_.data());
+    encodeRecord(record, faultPayload_.data() + kBatchHeaderSize, kWireRecordSize);
+    size_t len = appendBatchTrailer(faultPayload_.data(), kBatchHeaderSize + kWireRecordSize, faultPayload_.size(),
+                                    monotonicNs(Clock::now()), true);
+    if (!transport_.sendPriority(faultPayload_.data(), len)) {
+        return false;
+    }
+    ++faultMessagesSent_;
+    noteSent(1, len);
+    return true;
+}
+
+bool MessageBatcher::add(const WireRecord& record) {
+    if (prioritizeFaults_ && isFaultStatus(record.status)) {
+        return sendFault(record) && flushIfDue();
+    }
+    if (encoding_ == BatchEncoding::Delta) {
+        if (pending_ > 0 && encoder_.sizeWith(record) > payloadLimit_ && !flush()) {
+            return false;
+        }
+        encoder_.add(record);
+    } else {
+        encodeRecord(record, payload_.data() + kBatchHeaderSize + pending_ * kWireRecordSize, kWireRecordSize);
+    }
+    notePending();
+    if (pending_ == maxRecords_) {
+        return flush();
+    }
+    return flushIfDue();
+}
+
+bool MessageBatcher::flushIfDue() {
+    if (pending_ == 0 || Clock::now() - oldestPending_ < flushInterval_) {
+        return true;
+    }
+    return flush();
+}
+
+bool MessageBatcher::flush() {
+    if (pending_ == 0) {
+        return true;
+    }
+    size_t len = 0;
+    if (encoding_ == BatchEncoding::Delta) {
+        auto start = Clock::now();
+        len = encoder_.finish(payload_.data(), payloadLimit_);
+        encodeTime_ += Clock::now() - start;
+        encoder_.reset();
+        if (len == 0) {
+            // Only a single record larger than the whole message can get here.
+            std::cerr << "Record batch does not fit a " << payloadLimit_ << "-byte message\n";
+            pending_ = 0;
+            return false;
+        }
+    } else {
+        encodeBatchHeader(static_cast<uint16_t>(pending_), payload_.data());
+        len = kBatchHeaderSize + pending_ * kWireRecordSize;
+    }
+    len = appendBatchTrailer(payload_.data(), len, payload_.size(), monotonicNs(oldestPending_), false);
+    if (!transport_.send(payload_.data(), len)) {
+        return false;
+    }
+    noteSent(pending_, len);
+    pending_ = 0;
+    return true;
+}
+
+void MessageBatcher::printStats(std::ostream& os) const {
+    double seconds = std::chrono::duration<double>(lastSend_ - firstSend_).count();
+    double perMessage = messagesSent_ > 0 ? static_cast<double>(recordsSent_) / messagesSent_ : 0.0;
+    os << "Batches sent: " << messagesSent_ << ", records: " << recordsSent_ << ", records/message: " << perMessage;
+    if (encoding_ == BatchEncoding::Delta) {
+        os << " (limit " << payloadLimit_ << " bytes)";
+    } else {
+        os << " (limit " << maxRecords_ << ")";
+    }
+    if (seconds > 0) {
+        os << ", messages/s: " << messagesSent_ / seconds;
+    }
+    os << '\n';
+    if (prioritizeFaults_) {
+        os << "Fault messages sent ahead of batches: " << faultMessagesSent_ << '\n';
+    }
+    // Compare against what the fixed layout would have put through the transport.
+    size_t fixedBytes = messagesSent_ * (kBatchHeaderSize + kBatchTrailerSize) + recordsSent_ * kWireRecordSize;
+    os << "Encoding: " << batchEncodingToString(encoding_) << ", bytes sent: " << bytesSent_;
+    if (bytesSent_ > 0 && recordsSent_ > 0) {
+        os << ", bytes/record: " << static_cast<double>(bytesSent_) / recordsSent_
+           << ", ratio vs fixed: " << static_cast<double>(fixedBytes) / bytesSent_;
+    }
+    double encodeSeconds = std::chrono::duration<double>(encodeTime_).count();
+    if (encodeSeconds > 0) {
+        os << ", encode: " << recordsSent_ / encodeSeconds / 1e6 << " M records/s";
+    }
+    os << '\n';
+}
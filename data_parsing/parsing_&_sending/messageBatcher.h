@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "../common/batchCodec.h"
+#include "../common/transport.h"
+#include "../common/vehicleWire.h"
+
+// Packs as many records as fit into one transport message (for the SysV
+// queue that is the kernel's msgmax) and sends it when full or when the
+// oldest buffered record has waited longer than the flush interval. With the
+// delta encoding "full" is measured in encoded bytes, not records.
+// With fault priority on, overheat and sensor-failure records skip the batch:
+// each goes out at once in its own message through Transport::sendPriority.
+// Every message carries the time its oldest record was queued so the
+// receiver can measure end-to-end latency.
+class MessageBatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit MessageBatcher(Transport& transport,
+                            std::chrono::microseconds flushInterval = std::chrono::milliseconds(5),
+                            BatchEncoding encoding = BatchEncoding::Delta, bool prioritizeFaults = true);
+
+    bool add(const WireRecord& record);
+    // Sends the pending batch if its oldest record is past the flush interval.
+    bool flushIfDue();
+    // Sends whatever is pending.
+    bool flush();
+
+    size_t messagesSent() const { return messagesSent_; }
+    size_t recordsSent() const { return recordsSent_; }
+    size_t recordsPerMessageLimit() const { return maxRecords_; }
+    size_t bytesSent() const { return bytesSent_; }
+    size_t faultMessagesSent() const { return faultMessagesSent_; }
+    // One-line throughput and compression summary, e.g. for the end of a run.
+    void printStats(std::ostream& os) const;
+
+private:
+    void notePending();
+    void noteSent(size_t records, size_t bytes);
+    bool sendFault(const WireRecord& record);
+    static int64_t monotonicNs(Clock::time_point t);
+
+    Transport& transport_;
+    std::chrono::microseconds flushInterval_;
+    BatchEncoding encoding_;
+    bool prioritizeFaults_;
+    std::vector<unsigned char> payload_;
+    std::vector<unsigned char> faultPayload_;
+    size_t payloadLimit_;
+    size_t maxRecords_;
+    DeltaBatchEncoder encoder_;
+    std::chrono::nanoseconds encodeTime_{0};
+    size_t pending_ = 0;
+    Clock::time_point oldestPending_{};
+    Clock::time_point firstSend_{};
+    Clock::time_point lastSend_{};
+    size_t messagesSent_ = 0;
+    size_t recordsSent_ = 0;
+    size_t bytesSent_ = 0;
+    size_t faultMessagesSent_ = 0;
+};
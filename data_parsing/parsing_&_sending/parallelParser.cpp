@@ -0,0 +1,86 @@
+#include "parallelParser.h"
+#include "fieldScanner.h"
+#include "mappedFile.h"
+#include "../common/orderedRun.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+constexpr size_t kFieldCount = 5;
+
+}  // namespace
+
+ParallelChunkParser::ParallelChunkParser(VehicleDataParser& parser, size_t threadCount, size_t chunkBytes,
+                                         size_t window)
+    : parser_(&parser),
+      threadCount_(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+      chunkBytes_(std::max<size_t>(chunkBytes, 1)),
+      window_(window != 0 ? window : threadCount_ * 2),
+      workers_(threadCount_) {}
+
+void ParallelChunkParser::parseChunk(VehicleDataParser& worker, std::string_view chunk, ParsedChunk& out) {
+    std::vector<uint32_t>& offsets = worker.separatorScratch();
+    offsets.clear();
+    scanSeparators(chunk, offsets);
+    LineFieldIterator lines(chunk, offsets);
+    std::string_view line;
+    std::string_view fields[kFieldCount];
+    size_t fieldCount = 0;
+
+    out.recordCount = 0;
+    out.rejected.clear();
+    out.lineCount = 0;
+    while (lines.next(line, fields, kFieldCount, fieldCount)) {
+        size_t lineInChunk = out.lineCount++;
+        if (line.empty()) {
+            continue;
+        }
+        // Grow only; entries are overwritten in place on later chunks.
+        if (out.recordCount == out.records.size()) {
+            out.records.emplace_back();
+            out.recordLines.emplace_back();
+        }
+        VehicleData& data = out.records[out.recordCount];
+        ParseStatus status = worker.decodeFields(fields, recordFieldCount(line, fieldCount), data);
+        if (status != ParseStatus::E_OK) {
+            out.rejected.push_back(RejectedLine{lineInChunk, line, status});
+            continue;
+        }
+        out.recordLines[out.recordCount++] = static_cast<uint32_t>(lineInChunk);
+    }
+}
+
+bool ParallelChunkParser::run(std::string_view contents, const ChunkSink& sink) {
+    // Chunk boundaries are cheap to find (one memchr per chunk), so compute them up front.
+    std::vector<std::string_view>& chunks = chunks_;
+    chunks.clear();
+    size_t pos = 0;
+    for (auto chunk = nextLineChunk(contents, pos, chunkBytes_); !chunk.empty();
+         chunk = nextLineChunk(contents, pos, chunkBytes_)) {
+        chunks.push_back(chunk);
+    }
+    if (chunks.empty()) {
+        return true;
+    }
+
+    const OrderedRunOptions options{chunks.size(), threadCount_, window_};
+    const size_t workers = orderedRunWorkers(options);
+    if (slots_.size() < orderedRunWindow(options)) {
+        slots_.resize(orderedRunWindow(options));
+    }
+    size_t firstLineNumber = 1;
+    const bool completed = runInOrder(
+        options,
+        [&](size_t worker, uint64_t index, size_t slot) { parseChunk(workers_[worker], chunks[index], slots_[slot]); },
+        [&](uint64_t, size_t slot) {
+            const bool keepGoing = sink(slots_[slot], firstLineNumber);
+            firstLineNumber += slots_[slot].lineCount;
+            return keepGoing;
+        });
+    for (size_t i = 0; i < workers; ++i) {
+        parser_->mergeErrors(workers_[i].errors());
+        workers_[i].resetErrors();
+    }
+    return completed;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include "string_parsing.h"
+
+struct RejectedLine {
+    size_t lineInChunk;  // 0-based within the chunk
+    std::string_view line;
+    ParseStatus status;
+};
+
+// Output of parsing one line-aligned chunk. Buffers are reused between chunks,
+// so only the first recordCount entries of records/recordLines are valid.
+struct ParsedChunk {
+    std::vector<VehicleData> records;
+    std::vector<uint32_t> recordLines;  // 0-based line within the chunk, per record
+    size_t recordCount = 0;
+    std::vector<RejectedLine> rejected;
+    size_t lineCount = 0;
+};
+
+// Splits a buffer at line boundaries and parses the chunks on a pool of
+// threads, handing them back to the caller's thread strictly in file order.
+// Each worker thread parses with its own VehicleDataParser; their error counts
+// are merged into the parser given to the constructor (or to rebind()) when a
+// run ends. Worker parsers and chunk buffers are kept between runs.
+class ParallelChunkParser {
+public:
+    // Called once per chunk, in order. firstLineNumber is the 1-based file line
+    // number of the chunk's first line. Return false to stop early.
+    using ChunkSink = std::function<bool(const ParsedChunk& chunk, size_t firstLineNumber)>;
+
+    // threadCount 0 means std::thread::hardware_concurrency(). At most
+    // `window` chunks are parsed ahead of the sink, bounding memory use.
+    // parser only collects error counts and must outlive this object.
+    ParallelChunkParser(VehicleDataParser& parser, size_t threadCount = 0, size_t chunkBytes = 4 << 20,
+                        size_t window = 0);
+
+    // Returns false if the sink stopped the run.
+    bool run(std::string_view contents, const ChunkSink& sink);
+    // Collects error counts into another parser from now on; a parser that
+    // owns this object calls it when it is moved.
+    void rebind(VehicleDataParser& parser) { parser_ = &parser; }
+
+    size_t threadCount() const { return threadCount_; }
+
+private:
+    static void parseChunk(VehicleDataParser& worker, std::string_view chunk, ParsedChunk& out);
+
+    VehicleDataParser* parser_;
+    size_t threadCount_;
+    size_t chunkBytes_;
+    size_t window_;
+    std::vector<VehicleDataParser> workers_;
+    std::vector<ParsedChunk> slots_;
+    std::vector<std::string_view> chunks_;
+};
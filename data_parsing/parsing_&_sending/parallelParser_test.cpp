@@ -0,0 +1,153 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include "parallelParser.h"
+
+int main() {
+    std::cout << "[Test] starting parallel chunk parser tests\n";
+
+    // Build a buffer where every 7th line is malformed and every 11th is blank.
+    std::string buf;
+    size_t expectedRecords = 0;
+    size_t expectedRejected = 0;
+    const size_t lineCount = 20000;
+    for (size_t i = 1; i <= lineCount; ++i) {
+        if (i % 11 == 0) {
+            buf += "\n";
+        } else if (i % 7 == 0) {
+            buf += std::to_string(i) + ",BROKEN\n";
+            ++expectedRejected;
+        } else {
+            buf += std::to_string(i) + ",2026-02-14 10:15:23,88.5,1,ENGINE_OK\n";
+            ++expectedRecords;
+        }
+    }
+
+    // Test 1: records and rejects come back in file order with correct line numbers,
+    // for several thread counts and chunk sizes (small chunks force many of them).
+    for (size_t threads : {1, 2, 8}) {
+        for (size_t chunkBytes : {64, 4096, 1 << 20}) {
+            VehicleDataParser parser;
+            ParallelChunkParser chunkParser(parser, threads, chunkBytes);
+            size_t records = 0;
+            size_t rejected = 0;
+            size_t lastLine = 0;
+            bool ok = chunkParser.run(buf, [&](const ParsedChunk& chunk, size_t firstLineNumber) {
+                for (size_t i = 0; i < chunk.recordCount; ++i) {
+                    size_t lineNumber = firstLineNumber + chunk.recordLines[i];
+                    // Each valid line carries its own line number as vehicleId.
+                    assert(chunk.records[i].vehicleId == static_cast<int>(lineNumber));
+                    assert(lineNumber > lastLine);
+                    lastLine = lineNumber;
+                }
+                for (const auto& r : chunk.rejected) {
+                    assert((firstLineNumber + r.lineInChunk) % 7 == 0);
+                    assert(r.status == ParseStatus::E_FieldCount);
+                }
+                records += chunk.recordCount;
+                rejected += chunk.rejected.size();
+                return true;
+            });
+            assert(ok);
+            assert(records == expectedRecords);
+            assert(rejected == expectedRejected);
+            // Worker error counts are merged into the caller's parser.
+            assert(parser.errors().parsed == expectedRecords);
+            assert(parser.errors().rejected() == expectedRejected);
+            assert(parser.errors().byStatus[static_cast<size_t>(ParseStatus::E_FieldCount)] == expectedRejected);
+            std::cout << "[Test1] threads=" << threads << " chunkBytes=" << chunkBytes << " ok\n";
+        }
+    }
+
+    // Test 2: a sink returning false stops the run without hanging the workers.
+    {
+        VehicleDataParser parser;
+        ParallelChunkParser chunkParser(parser, 4, 64, 2);
+        size_t calls = 0;
+        bool ok = chunkParser.run(buf, [&](const ParsedChunk&, size_t) { return ++calls < 3; });
+        assert(!ok);
+        assert(calls == 3);
+        std::cout << "[Test2] early stop ok\n";
+    }
+
+    // Test 3: a chunk parser is reusable, and separate parser instances on
+    // separate threads keep separate counts.
+    {
+        VehicleDataParser parser;
+        ParallelChunkParser chunkParser(parser, 2, 4096);
+        for (int run = 0; run < 3; ++run) {
+            assert(chunkParser.run(buf, [](const ParsedChunk&, size_t) { return true; }));
+        }
+        assert(parser.errors().parsed == 3 * expectedRecords);
+        assert(parser.errors().rejected() == 3 * expectedRejected);
+
+        // A date past int64 nanoseconds is a bad timestamp, not a wrapped one.
+        VehicleData farFuture{};
+        assert(parser.parseLine("7,9999-12-31 23:59:59,88.5,1,ENGINE_OK", farFuture) ==
+               ParseStatus::E_InvalidTimestamp);
+
+        // One trailing comma is tolerated, as the getline() split did; two are not.
+        VehicleData trailing{};
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,ENGINE_OK,", trailing) == ParseStatus::E_OK);
+        assert(trailing.speed == 88.5 && trailing.errorCode == EngineStatus::OK);
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,ENGINE_OK,\r", trailing) == ParseStatus::E_OK);
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,,", trailing) == ParseStatus::E_OK);
+        assert(trailing.errorCode == EngineStatus::E_Unknown);
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,ENGINE_OK,,", trailing) == ParseStatus::E_FieldCount);
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,ENGINE_OK,x", trailing) == ParseStatus::E_FieldCount);
+        assert(parser.parseLine("7,2026-02-14 10:15:23,88.5,1,", trailing) == ParseStatus::E_FieldCount);
+        std::string trailingChunk = "7,2026-02-14 10:15:23,88.5,1,ENGINE_OK,\n8,2026-02-14 10:15:23,1.0,0,OK,,\n";
+        size_t trailingRecords = 0;
+        size_t trailingRejected = 0;
+        assert(chunkParser.run(trailingChunk, [&](const ParsedChunk& chunk, size_t) {
+            trailingRecords += chunk.recordCount;
+            trailingRejected += chunk.rejected.size();
+            return true;
+        }));
+        assert(trailingRecords == 1 && trailingRejected == 1);
+
+        VehicleDataParser parsers[2];
+        std::thread threads[2];
+        for (int t = 0; t < 2; ++t) {
+            threads[t] = std::thread([&, t] {
+                VehicleData data{};
+                for (int i = 0; i < 1000 * (t + 1); ++i) {
+                    parsers[t].parseLine("7,2026-02-14 10:15:23,88.5,1,ENGINE_OK", data);
+                    parsers[t].parseLine("7,2026-02-14 10:15:23,fast,1,ENGINE_OK", data);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int t = 0; t < 2; ++t) {
+            const size_t n = 1000 * (t + 1);
+            assert(parsers[t].errors().parsed == n);
+            assert(parsers[t].errors().byStatus[static_cast<size_t>(ParseStatus::E_InvalidSpeed)] == n);
+        }
+        std::cout << "[Test3] reusable per-thread parsers ok\n";
+    }
+
+    // Test 4: after rebind() (what a moved VehicleDataParser does to the chunk
+    // parser it owns) counts go to the new parser only.
+    {
+        VehicleDataParser first;
+        VehicleDataParser second;
+        ParallelChunkParser chunkParser(first, 2, 4096);
+        assert(chunkParser.run(buf, [](const ParsedChunk&, size_t) { return true; }));
+        chunkParser.rebind(second);
+        assert(chunkParser.run(buf, [](const ParsedChunk&, size_t) { return true; }));
+        assert(first.errors().parsed == expectedRecords);
+        assert(second.errors().parsed == expectedRecords);
+        assert(second.errors().rejected() == expectedRejected);
+
+        VehicleDataParser moved(std::move(second));
+        assert(moved.errors().parsed == expectedRecords);
+        std::cout << "[Test4] rebinding error counts ok\n";
+    }
+
+    std::cout << "\n[Test] all parallel chunk parser tests passed\n";
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "partitionRouter.h"
+#include <cstdio>
+
+PartitionRouter::PartitionRouter(std::vector<std::unique_ptr<Transport>> transports, BatchEncoding encoding,
+                                 bool prioritizeFaults, std::chrono::microseconds flushInterval)
+    : transports_(std::move(transports)) {
+    for (auto& transport : transports_) {
+        batchers_.push_back(std::make_unique<MessageBatcher>(*transport, flushInterval, encoding, prioritizeFaults));
+    }
+}
+
+bool PartitionRouter::add(const WireRecord& record) {
+    if (!started_) {
+        firstAdd_ = Clock::now();
+        started_ = true;
+    }
+    uint32_t partition = batchers_.size() == 1 ? 0 : partitionForVehicle(record.vehicleId, partitionCount());
+    if (!batchers_[partition]->add(record)) {
+        return false;
+    }
+    // A quiet partition must not sit on records just because traffic goes elsewhere.
+    if (batchers_.size() > 1) {
+        return flushIfDue();
+    }
+    return true;
+}
+
+bool PartitionRouter::flushIfDue() {
+    for (auto& batcher : batchers_) {
+        if (!batcher->flushIfDue()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PartitionRouter::flush() {
+    for (auto& batcher : batchers_) {
+        if (!batcher->flush()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PartitionRouter::sendEndOfStream() {
+    if (!flush()) {
+        return false;
+    }
+    for (auto& transport : transports_) {
+        if (!transport->sendEndOfStream()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PartitionRouter::recordsSent() const {
+    size_t total = 0;
+    for (const auto& batcher : batchers_) {
+        total += batcher->recordsSent();
+    }
+    return total;
+}
+
+void PartitionRouter::printStats(std::ostream& os) const {
+    if (batchers_.size() == 1) {
+        batchers_[0]->printStats(os);
+        transports_[0]->printStats(os);
+        return;
+    }
+    const double seconds = started_ ? std::chrono::duration<double>(Clock::now() - firstAdd_).count() : 0.0;
+    const size_t total = recordsSent();
+    os << "Partitions: " << batchers_.size() << ", records: " << total << '\n';
+    for (size_t p = 0; p < batchers_.size(); ++p) {
+        const MessageBatcher& batcher = *batchers_[p];
+        char line[160];
+        std::snprintf(line, sizeof(line),
+                      "Partition %zu: records: %zu (%.1f%%), messages: %zu, bytes: %zu, records/s: %.0f\n", p,
+                      batcher.recordsSent(), total > 0 ? 100.0 * batcher.recordsSent() / total : 0.0,
+                      batcher.messagesSent(), batcher.bytesSent(),
+                      seconds > 0 ? batcher.recordsSent() / seconds : 0.0);
+        os << line;
+        transports_[p]->printStats(os);
+    }
+}
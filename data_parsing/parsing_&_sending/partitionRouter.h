@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "../common/batchCodec.h"
+#include "../common/partitioning.h"
+#include "../common/transport.h"
+#include "messageBatcher.h"
+
+// Fans records out over one transport per partition, choosing the partition
+// from the vehicleId with partitionForVehicle(). Each partition has its own
+// MessageBatcher, so a vehicle's records stay in order on one channel while
+// separate receivers drain the partitions in parallel. With a single
+// partition it behaves exactly like one MessageBatcher.
+class PartitionRouter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PartitionRouter(std::vector<std::unique_ptr<Transport>> transports, BatchEncoding encoding,
+                    bool prioritizeFaults = true,
+                    std::chrono::microseconds flushInterval = std::chrono::milliseconds(5));
+
+    bool add(const WireRecord& record);
+    bool flushIfDue();
+    bool flush();
+    // Flushes, then ends the stream on every partition.
+    bool sendEndOfStream();
+
+    uint32_t partitionCount() const { return static_cast<uint32_t>(batchers_.size()); }
+    size_t recordsSent() const;
+    // Batcher summary; with several partitions also one line per partition
+    // with its share of the records and its throughput.
+    void printStats(std::ostream& os) const;
+
+private:
+    std::vector<std::unique_ptr<Transport>> transports_;
+    std::vector<std::unique_ptr<MessageBatcher>> batchers_;
+    Clock::time_point firstAdd_{};
+    bool started_ = false;
+};
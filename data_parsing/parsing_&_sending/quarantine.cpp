@@ -0,0 +1,141 @@
+#include "quarantine.h"
+
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+QuarantineSink::QuarantineSink(std::ostream& diagnostics, std::chrono::milliseconds summaryInterval)
+    : diagnostics_(diagnostics), summaryInterval_(summaryInterval) {}
+
+QuarantineSink::~QuarantineSink() {
+    flush();
+    if (fd_ != -1) {
+        ::close(fd_);
+    }
+}
+
+bool QuarantineSink::open(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        perror("open quarantine file");
+        return false;
+    }
+    path_ = path;
+    buffer_.reserve(kFlushBytes + 4096);
+    return true;
+}
+
+void QuarantineSink::reject(size_t lineNumber, ParseStatus reason, std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    ++total_;
+    ++byReason_[static_cast<size_t>(reason)];
+    if (fd_ != -1) {
+        char number[24];
+        auto end = std::to_chars(number, number + sizeof(number), lineNumber).ptr;
+        buffer_.append(number, end);
+        buffer_ += '\t';
+        buffer_ += parseStatusCode(reason);
+        buffer_ += '\t';
+        buffer_.append(line);
+        buffer_ += '\n';
+        if (buffer_.size() >= kFlushBytes) {
+            flush();
+        }
+    }
+    noteRejectForDiagnostics(lineNumber, reason, line);
+}
+
+void QuarantineSink::noteRejectForDiagnostics(size_t lineNumber, ParseStatus reason, std::string_view line) {
+    if (total_ <= kEchoedRejects) {
+        diagnostics_ << "Skipping line " << lineNumber << ": " << parseStatusToString(reason) << " -> " << line
+                     << '\n';
+        if (total_ == kEchoedRejects) {
+            diagnostics_ << "Further malformed lines are summarized"
+                         << (fd_ != -1 ? " and quarantined to " + path_ : std::string()) << '\n';
+            lastSummary_ = Clock::now();
+        }
+        return;
+    }
+    ++suppressed_;
+    lastSuppressedLine_ = lineNumber;
+    // Checking the clock only every 64 rejects keeps a corrupt section cheap;
+    // flush() catches the rest.
+    if ((suppressed_ & 63) == 0 && summarizeIfDue(Clock::now())) {
+        flush();
+    }
+}
+
+bool QuarantineSink::summarizeIfDue(Clock::time_point now) {
+    if (now - lastSummary_ < summaryInterval_) {
+        return false;
+    }
+    diagnostics_ << "Skipped " << suppressed_ << " more malformed lines (" << total_ << " total, last at line "
+                 << lastSuppressedLine_ << ")\n";
+    diagnostics_.flush();
+    suppressed_ = 0;
+    lastSummary_ = now;
+    return true;
+}
+
+bool QuarantineSink::flush() {
+    if (suppressed_ > 0) {
+        summarizeIfDue(Clock::now());
+    }
+    if (fd_ == -1 || buffer_.empty()) {
+        return !writeFailed_;
+    }
+    const char* cursor = buffer_.data();
+    size_t remaining = buffer_.size();
+    while (remaining > 0 && !writeFailed_) {
+        ssize_t written = ::write(fd_, cursor, remaining);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Keep counting; losing the file must not stop the feed.
+            perror("write quarantine file");
+            writeFailed_ = true;
+            break;
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    buffer_.clear();
+    return !writeFailed_;
+}
+
+void QuarantineSink::printSummary(std::ostream& os) const {
+    if (total_ == 0) {
+        return;
+    }
+    os << "Rejected lines: " << total_;
+    if (fd_ != -1) {
+        os << " (quarantined to " << path_ << ')';
+    }
+    os << '\n';
+    for (size_t i = 1; i < kParseStatusCount; ++i) {
+        if (byReason_[i] == 0) {
+            continue;
+        }
+        char line[96];
+        std::snprintf(line, sizeof(line), "  %-16s %zu\n", parseStatusCode(static_cast<ParseStatus>(i)),
+                      byReason_[i]);
+        os << line;
+    }
+}
+
+void quarantinePathFromArgs(int argc, char** argv, std::string& path) {
+    constexpr std::string_view kPrefix = "--quarantine=";
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, kPrefix.size()) == kPrefix) {
+            path = std::string(arg.substr(kPrefix.size()));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "string_parsing.h"
+
+// Where rejected input lines go. Each one is appended to a buffered
+// quarantine file (if a path was given) as
+//     <line number>\t<reason code>\t<original line>
+// and counted by reason. Diagnostics are kept cheap: the first few rejects
+// are echoed individually, after that at most one summary line per interval
+// (checked as rejects arrive and on flush(), so a slow trickle is reported
+// too), and printSummary() gives the final per-reason histogram.
+class QuarantineSink {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kEchoedRejects = 10;
+
+    explicit QuarantineSink(std::ostream& diagnostics, std::chrono::milliseconds summaryInterval =
+                                                             std::chrono::seconds(1));
+    ~QuarantineSink();
+    QuarantineSink(const QuarantineSink&) = delete;
+    QuarantineSink& operator=(const QuarantineSink&) = delete;
+
+    // Opens (truncating) the quarantine file. Without it only counts and diagnostics are kept.
+    bool open(const std::string& path);
+
+    void reject(size_t lineNumber, ParseStatus reason, std::string_view line);
+    // Writes buffered quarantine lines to the file, and the summary of
+    // suppressed rejects if one is due.
+    bool flush();
+
+    size_t rejected() const { return total_; }
+    size_t rejected(ParseStatus reason) const { return byReason_[static_cast<size_t>(reason)]; }
+    // "Rejected lines: N (quarantined to <path>)" plus one line per reason seen.
+    void printSummary(std::ostream& os) const;
+
+private:
+    void noteRejectForDiagnostics(size_t lineNumber, ParseStatus reason, std::string_view line);
+    // Prints the suppressed-rejects line if the interval has elapsed.
+    bool summarizeIfDue(Clock::time_point now);
+
+    static constexpr size_t kFlushBytes = 1 << 20;
+
+    std::ostream& diagnostics_;
+    std::chrono::milliseconds summaryInterval_;
+    int fd_ = -1;
+    std::string path_;
+    std::string buffer_;
+    size_t total_ = 0;
+    size_t byReason_[kParseStatusCount] = {};
+    size_t suppressed_ = 0;  // rejects since the last diagnostic line
+    size_t lastSuppressedLine_ = 0;
+    Clock::time_point lastSummary_{};
+    bool writeFailed_ = false;
+};
+
+// Reads --quarantine=<path>. Leaves path empty if absent.
+void quarantinePathFromArgs(int argc, char** argv, std::string& path);
@@ -0,0 +1,118 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "quarantine.h"
+
+namespace {
+
+size_t countLines(const std::string& text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    return lines;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "[Test] starting quarantine sink tests\n";
+    char path[] = "/tmp/quarantine_test.XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    // Test 1: every reject lands in the file with its line number and reason code.
+    {
+        std::ostringstream diag;
+        {
+            QuarantineSink sink(diag);
+            assert(sink.open(path));
+            sink.reject(12, ParseStatus::E_FieldCount, "1011,INVALID_DATA");
+            sink.reject(13, ParseStatus::E_InvalidSpeed, "1012,2026-02-14 10:24:55,abc,1,ENGINE_OK\r");
+            sink.reject(15, ParseStatus::E_InvalidEngine, "1013,2026-02-14 10:26:30,98.2,2,ENGINE_OK");
+            assert(sink.rejected() == 3);
+            assert(sink.rejected(ParseStatus::E_InvalidSpeed) == 1);
+
+            std::ostringstream summary;
+            sink.printSummary(summary);
+            assert(summary.str().find("Rejected lines: 3") != std::string::npos);
+            assert(summary.str().find("BAD_SPEED") != std::string::npos);
+            assert(summary.str().find("BAD_ID") == std::string::npos);
+        }
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        assert(contents.str() ==
+               "12\tFIELD_COUNT\t1011,INVALID_DATA\n"
+               "13\tBAD_SPEED\t1012,2026-02-14 10:24:55,abc,1,ENGINE_OK\n"
+               "15\tBAD_ENGINE\t1013,2026-02-14 10:26:30,98.2,2,ENGINE_OK\n");
+        assert(countLines(diag.str()) == 3);
+        std::cout << "[Test1] quarantine file format ok\n";
+    }
+
+    // Test 2: a corrupt section produces a bounded number of diagnostic lines,
+    // while the file still gets every reject.
+    {
+        std::ostringstream diag;
+        const size_t rejects = 200000;
+        {
+            QuarantineSink sink(diag, std::chrono::hours(1));
+            assert(sink.open(path));
+            for (size_t i = 0; i < rejects; ++i) {
+                sink.reject(i + 1, ParseStatus::E_InvalidTimestamp, "7,not a time,1.0,1,OK");
+            }
+            assert(sink.rejected(ParseStatus::E_InvalidTimestamp) == rejects);
+        }
+        // The echoed rejects plus the "summarized" notice; the interval never elapses.
+        assert(countLines(diag.str()) == QuarantineSink::kEchoedRejects + 1);
+        std::ifstream file(path);
+        std::string line;
+        size_t lines = 0;
+        while (std::getline(file, line)) {
+            ++lines;
+        }
+        assert(lines == rejects);
+        std::cout << "[Test2] rate-limited diagnostics ok\n";
+    }
+
+    // Test 3: without a file only counts and diagnostics are kept.
+    {
+        std::ostringstream diag;
+        QuarantineSink sink(diag, std::chrono::milliseconds(0));
+        for (size_t i = 0; i < 1000; ++i) {
+            sink.reject(i + 1, ParseStatus::E_InvalidId, ",x");
+        }
+        assert(sink.rejected() == 1000);
+        assert(diag.str().find("Skipped") != std::string::npos);
+        std::cout << "[Test3] counts without a file ok\n";
+    }
+
+    // Test 4: a trickle too slow to reach the per-64 clock check is still
+    // summarized, by the flush() that follows each followed batch.
+    {
+        std::ostringstream diag;
+        QuarantineSink sink(diag, std::chrono::milliseconds(200));
+        for (size_t i = 0; i < QuarantineSink::kEchoedRejects + 3; ++i) {
+            sink.reject(i + 1, ParseStatus::E_InvalidSpeed, "7,2026-02-14 10:24:55,x,1,OK");
+        }
+        sink.flush();
+        assert(diag.str().find("Skipped") == std::string::npos);
+        usleep(250 * 1000);
+        sink.flush();
+        assert(diag.str().find("Skipped 3 more malformed lines (13 total, last at line 13)") != std::string::npos);
+        const size_t lines = countLines(diag.str());
+        sink.flush();
+        assert(countLines(diag.str()) == lines);
+        std::cout << "[Test4] slow trickle summarized on flush ok\n";
+    }
+
+    unlink(path);
+    std::cout << "\n[Test] all quarantine sink tests passed\n";
+    return 0;
+}
@@ -1,5 +1,40 @@
 #include "string_parsing.h"
+#include "fileFollower.h"
+#include "mappedFile.h"
+#include "parallelParser.h"
+#include "quarantine.h"
+#include "vehicleSchema.h"
+#include "../common/timestamp.h"
+#include <charconv>
+#include <csignal>
 #include <cstdio>
+#include <utility>
+
+VehicleDataParser::VehicleDataParser() = default;
+VehicleDataParser::~VehicleDataParser() = default;
+
+// Written out because the chunk parser keeps a pointer back to its owner for
+// merging error counts, and that has to follow the parser to its new address.
+VehicleDataParser::VehicleDataParser(VehicleDataParser&& other) noexcept
+    : errors_(other.errors_),
+      separators_(std::move(other.separators_)),
+      chunkParser_(std::move(other.chunkParser_)),
+      quarantine_(other.quarantine_) {
+    if (chunkParser_ != nullptr) {
+        chunkParser_->rebind(*this);
+    }
+}
+
+VehicleDataParser& VehicleDataParser::operator=(VehicleDataParser&& other) noexcept {
+    errors_ = other.errors_;
+    separators_ = std::move(other.separators_);
+    chunkParser_ = std::move(other.chunkParser_);
+    quarantine_ = other.quarantine_;
+    if (chunkParser_ != nullptr) {
+        chunkParser_->rebind(*this);
+    }
+    return *this;
+}
 
 VehicleDataParser* VehicleDataParser::getInstance() {
     static VehicleDataParser instance;
@@ -7,125 +42,221 @@ VehicleDataParser* VehicleDataParser::getInstance() {
 }
 
 
-bool VehicleDataParser::parseLine(const std::string& line, VehicleData& data) {
-    std::stringstream ss(line);
-    std::vector<std::string> fields;
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        fields.emplace_back(token);
+namespace {
+
+constexpr size_t kFieldCount = 5;
+
+static_assert(kVehicleSchema.kFieldCount == kFieldCount, "parseLine splits the schema's fields");
+
+ParseStatus decodeRecord(const std::string_view* fields, size_t fieldCount, VehicleData& data) {
+    return vehicleSchemaStatus(kVehicleSchema.decodeFields(fields, fieldCount, data));
+}
+
+}  // namespace
+
+const char* parseStatusToString(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::E_OK: return "ok";
+        case ParseStatus::E_FieldCount: return "expected 5 fields";
+        case ParseStatus::E_InvalidId: return "invalid vehicleId field";
+        case ParseStatus::E_InvalidTimestamp: return "invalid timestamp field";
+        case ParseStatus::E_InvalidSpeed: return "invalid speed field";
+        case ParseStatus::E_InvalidEngine: return "invalid engineOn field";
+        case ParseStatus::E_Truncated: return "line cut off by rotation";
     }
+    return "unknown";
+}
 
-    if (fields.size() != 5) {
-        std::cerr << "Malformed line: expected 5 fields, got " << fields.size()
-                  << " -> " << line << std::endl;
-        return false;
+const char* parseStatusCode(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::E_OK: return "OK";
+        case ParseStatus::E_FieldCount: return "FIELD_COUNT";
+        case ParseStatus::E_InvalidId: return "BAD_ID";
+        case ParseStatus::E_InvalidTimestamp: return "BAD_TIMESTAMP";
+        case ParseStatus::E_InvalidSpeed: return "BAD_SPEED";
+        case ParseStatus::E_InvalidEngine: return "BAD_ENGINE";
+        case ParseStatus::E_Truncated: return "TRUNCATED";
     }
+    return "UNKNOWN";
+}
 
-    try {
-        data.vehicleId = std::stoi(fields[0]);
-        data.timestamp = fields[1];
-        data.speed = std::stod(fields[2]);
+size_t recordFieldCount(std::string_view line, size_t splitCount) {
+    return !line.empty() && line.back() == ',' ? splitCount - 1 : splitCount;
+}
 
-        if (fields[3] == "1" || fields[3] == "ON" || fields[3] == "ENGINE_OK") {
-            data.engineOn = true;
-        } else if (fields[3] == "0" || fields[3] == "OFF") {
-            data.engineOn = false;
-        } else {
-            throw std::invalid_argument("invalid engineOn field");
-        }
+ParseStatus VehicleDataParser::parseLine(std::string_view line, VehicleData& data) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
 
-        if (fields[4] == "ENGINE_OK" || fields[4] == "OK") {
-            data.errorCode = EngineStatus::OK;
-        } else if (fields[4] == "ENGINE_OVERHEAT") {
-            data.errorCode = EngineStatus::E_Overheat;
-        } else if (fields[4] == "SENSOR_FAILURE" || fields[4] == "ENGINE_SENSOR_FAIL") {
-            data.errorCode = EngineStatus::E_SensorFailure;
-        } else {
-            data.errorCode = EngineStatus::E_Unknown;
+    std::string_view fields[kFieldCount];
+    size_t count = 0;
+    size_t pos = 0;
+    while (count < kFieldCount) {
+        size_t comma = line.find(',', pos);
+        if (comma == std::string_view::npos) {
+            fields[count++] = line.substr(pos);
+            pos = line.size() + 1;
+            break;
         }
-    } catch (const std::exception& ex) {
-        std::cerr << "Malformed line: " << ex.what() << " -> " << line << std::endl;
-        return false;
+        fields[count++] = line.substr(pos, comma - pos);
+        pos = comma + 1;
     }
-    return true;
+    while (pos <= line.size()) {
+        // Extra fields are only counted for the diagnostic.
+        size_t comma = line.find(',', pos);
+        ++count;
+        pos = comma == std::string_view::npos ? line.size() + 1 : comma + 1;
+    }
+
+    return decodeFields(fields, recordFieldCount(line, count), data);
 }
 
-bool messageQueueSend(int msgId, const VehicleData& data) {
+ParseStatus VehicleDataParser::decodeFields(const std::string_view* fields, size_t fieldCount, VehicleData& data) {
+    ParseStatus status = decodeRecord(fields, fieldCount, data);
+    errors_.record(status);
+    return status;
+}
 
-    Msg msg;
-    msg.type = 1;
-    std::snprintf(msg.text, sizeof(msg.text), "ID:%d,Time:%s,Speed:%.2f,Engine:%s,ErrorCode:%d",
-        data.vehicleId, data.timestamp.c_str(), data.speed, data.engineOn ? "ON" : "OFF", static_cast<int>(data.errorCode));
-    if (msgsnd(msgId, &msg, sizeof(msg.text), 0) == -1) {
-        perror("msgsnd");
+bool sendEndOfStreamMessage(PartitionRouter& router, OutputWriter& out) {
+    if (!router.sendEndOfStream()) {
         return false;
     }
-    std::cout << "Sent message successfully: " << msg.text << std::endl;
+    if (out.enabled(Verbosity::Normal)) {
+        out.append("Sent end-of-stream message\n");
+    }
     return true;
 }
 
-bool sendEmptyTerminationMessage() {
-    key_t key = MSG_QUEUE_KEY;
-
-    int msgid = msgget(key, IPC_CREAT | 0666);
-    if (msgid == -1) {
-        perror("msgget");
-        return false;
+bool VehicleDataParser::sendContents(std::string_view contents, PartitionRouter& router, OutputWriter& out,
+                                     SendCounters& counters, QuarantineSink& quarantine) {
+    const size_t baseLine = counters.lineCount;
+    bool sendFailed = false;
+    if (chunkParser_ == nullptr) {
+        chunkParser_ = std::make_unique<ParallelChunkParser>(*this);
     }
+    chunkParser_->run(contents, [&](const ParsedChunk& chunk, size_t firstLineNumber) {
+        firstLineNumber += baseLine;
+        counters.lineCount += chunk.lineCount;
+        for (const auto& rejected : chunk.rejected) {
+            quarantine.reject(firstLineNumber + rejected.lineInChunk, rejected.status, rejected.line);
+        }
+        counters.invalidCount += chunk.rejected.size();
+        for (size_t i = 0; i < chunk.recordCount; ++i) {
+            const VehicleData& data = chunk.records[i];
+            WireRecord record{data.vehicleId, data.timestampNs, data.speed, data.engineOn, data.errorCode};
+            if (!router.add(record)) {
+                std::cerr << "Unable to send message for line " << firstLineNumber + chunk.recordLines[i] << std::endl;
+                sendFailed = true;
+                return false;
+            }
+            if (out.enabled(Verbosity::Verbose)) {
+                out.appendRecord(record);
+            }
+            ++counters.validCount;
+        }
+        return true;
+    });
+    return !sendFailed;
+}
 
-    Msg msg{};
-    msg.type = 1;
-    msg.text[0] = '\0';
+namespace {
 
-    if (msgsnd(msgid, &msg, sizeof(msg.text), 0) == -1) {
-        perror("msgsnd");
-        return false;
-    }
-    std::cout << "Sent termination message (empty payload)" << std::endl;
-    return true;
+volatile std::sig_atomic_t gStopFollowing = 0;
+
+void onStopSignal(int) {
+    gStopFollowing = 1;
 }
 
-sendStatus VehicleDataParser::parseAndSend() {
-    // implementing message queue and sending data to receiver
-    key_t key = MSG_QUEUE_KEY;
+}  // namespace
+
+sendStatus VehicleDataParser::followAppends(const std::string& path, uint64_t offset, PartitionRouter& router,
+                                            OutputWriter& out, SendCounters& counters, QuarantineSink& quarantine) {
+    // No SA_RESTART, so a signal interrupts poll() and we can finish cleanly.
+    struct sigaction action {};
+    action.sa_handler = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
 
-    std::ifstream dataFile(DATA_FILE_PATH);
-    if (!dataFile.is_open()) {
+    FileFollower follower;
+    if (!follower.start(path, offset)) {
+        return sendStatus::E_Error;
+    }
+    if (out.enabled(Verbosity::Normal)) {
+        out.append("Following " + path + " for appended records (Ctrl-C to stop)\n");
+        out.flush();
+    }
+    constexpr auto kIdleWake = std::chrono::milliseconds(100);
+    std::string lines;
+    while (!gStopFollowing) {
+        FollowStatus status = follower.poll(kIdleWake, lines);
+        if (status == FollowStatus::E_Error) {
+            return sendStatus::E_Error;
+        }
+        if (!follower.truncatedLine().empty()) {
+            // The rest of that line never arrives, so it is rejected, not parsed.
+            errors_.record(ParseStatus::E_Truncated);
+            ++counters.invalidCount;
+            quarantine.reject(++counters.lineCount, ParseStatus::E_Truncated, follower.truncatedLine());
+        }
+        if (status == FollowStatus::E_Data) {
+            if (!sendContents(lines, router, out, counters, quarantine)) {
+                return sendStatus::E_Error;
+            }
+            // New data trickles in, so do not hold it back for a fuller batch.
+            if (!router.flush()) {
+                return sendStatus::E_Error;
+            }
+        }
+        // Also on idle wakes, so the summary of a last few rejects is not held back.
+        quarantine.flush();
+        out.flushIfDue();
+    }
+    if (out.enabled(Verbosity::Normal) && follower.rotations() > 0) {
+        out.append("Followed " + std::to_string(follower.rotations()) + " rotation(s)\n");
+    }
+    return sendStatus::E_OK;
+}
+
+sendStatus VehicleDataParser::parseAndSend(PartitionRouter& router, OutputWriter& out, bool follow) {
+    MappedFile dataFile;
+    if (!dataFile.open(DATA_FILE_PATH)) {
         std::cerr << "Failed to open data file : " << DATA_FILE_PATH << std::endl;
         return sendStatus::E_Error;
     }
 
+    std::string_view contents = dataFile.view();
+    if (follow) {
+        // A trailing partial line may still be being written; leave it to the follower.
+        size_t lastNewline = contents.rfind('\n');
+        contents = lastNewline == std::string_view::npos ? std::string_view() : contents.substr(0, lastNewline + 1);
+    }
 
-    int msgid = msgget(key, IPC_CREAT | 0666);
-    if (msgid == -1) {
-        perror("msgget");
+    QuarantineSink stderrOnly(std::cerr);
+    QuarantineSink& quarantine = quarantine_ != nullptr ? *quarantine_ : stderrOnly;
+    SendCounters counters;
+    if (!sendContents(contents, router, out, counters, quarantine) || !router.flush()) {
         return sendStatus::E_Error;
     }
-    
-    std::string line;
-    size_t lineNumber = 0;
-    size_t validCount = 0;
-    size_t invalidCount = 0;
-    while (std::getline(dataFile, line)) {
-        ++lineNumber;
-        if (line.empty()) {
-            continue;
-        }
-        VehicleData data;
-        if (!parseLine(line, data)) {
-            std::cerr << "Skipping line " << lineNumber << " due to parse error\n";
-            ++invalidCount;
-            continue;
-        }
-        if (!messageQueueSend(msgid, data)) {
-            std::cerr << "Unable to send message for line " << lineNumber << std::endl;
+    if (follow) {
+        const uint64_t consumed = contents.size();
+        dataFile.close();
+        if (followAppends(DATA_FILE_PATH, consumed, router, out, counters, quarantine) != sendStatus::E_OK ||
+            !router.flush()) {
             return sendStatus::E_Error;
         }
-        ++validCount;
     }
-    std::cout << "Finished sending messages. Valid lines: " << validCount << ", Invalid lines: " << invalidCount << std::endl;
 
-    if (!sendEmptyTerminationMessage()) {
+    std::ostringstream summary;
+    summary << "Finished sending messages. Valid lines: " << counters.validCount
+            << ", Invalid lines: " << counters.invalidCount << '\n';
+    quarantine.flush();
+    quarantine.printSummary(std::cerr);
+    router.printStats(summary);
+    out.append(summary.str());
+
+    if (!sendEndOfStreamMessage(router, out)) {
         std::cerr << "unable to send termination message to receiverManager" << std::endl;
         return sendStatus::E_Error;
     }
@@ -1,5 +1,8 @@
+#pragma once
+
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <fstream>
@@ -7,21 +10,60 @@
 #include <sys/ipc.h>
 #include <sys/msg.h>
 #include <memory>
+#include "partitionRouter.h"
+#include "../common/outputWriter.h"
+#include "../common/transport.h"
+#include "../common/vehicleWire.h"
 
 const std::string DATA_FILE_PATH = "vehicle_data.txt";
-constexpr key_t MSG_QUEUE_KEY = 0x2222;
 
-struct Msg {
-    long type;
-    char text[256];
+enum class ParseStatus : uint8_t {
+    E_OK = 0,
+    E_FieldCount,
+    E_InvalidId,
+    E_InvalidTimestamp,
+    E_InvalidSpeed,
+    E_InvalidEngine,
+    E_Truncated,  // a followed file was rotated or truncated mid-line
 };
 
-enum class EngineStatus : uint8_t {
-    OK = 0,
-    InvalidFormat,
-    E_SensorFailure,
-    E_Overheat,
-    E_Unknown,
+constexpr size_t kParseStatusCount = static_cast<size_t>(ParseStatus::E_Truncated) + 1;
+
+const char* parseStatusToString(ParseStatus status);
+// Stable upper-case code for files and logs, e.g. "FIELD_COUNT".
+const char* parseStatusCode(ParseStatus status);
+
+// Field count of a line split on every ','. As with the original getline()
+// split, a trailing ',' does not open another field, so
+// "1001,2026-02-14 10:15:23,88.5,1,ENGINE_OK," is a valid record and
+// "1001,2026-02-14 10:15:23,88.5,1," has four fields.
+size_t recordFieldCount(std::string_view line, size_t splitCount);
+
+// Per-reason outcome counts, accumulated by a parser across calls.
+struct ParseErrorCounts {
+    size_t parsed = 0;
+    size_t byStatus[kParseStatusCount] = {};  // index E_OK is unused
+
+    void record(ParseStatus status) {
+        if (status == ParseStatus::E_OK) {
+            ++parsed;
+        } else {
+            ++byStatus[static_cast<size_t>(status)];
+        }
+    }
+    size_t rejected() const {
+        size_t total = 0;
+        for (size_t i = 1; i < kParseStatusCount; ++i) {
+            total += byStatus[i];
+        }
+        return total;
+    }
+    void merge(const ParseErrorCounts& other) {
+        parsed += other.parsed;
+        for (size_t i = 0; i < kParseStatusCount; ++i) {
+            byStatus[i] += other.byStatus[i];
+        }
+    }
 };
 
 enum class sendStatus : uint8_t {
@@ -29,23 +71,70 @@ enum class sendStatus : uint8_t {
     E_Error,
 };
 
+// Plain value type: no heap members, so chunk buffers of these are reused without
+// allocating. The timestamp is kept as UTC epoch nanoseconds; use formatTimestamp
+// to get the text form back.
 struct VehicleData {
     int vehicleId;
-    std::string timestamp;
+    int64_t timestampNs;
     double speed;
     bool engineOn;
     EngineStatus errorCode;
 };
 
+class ParallelChunkParser;
+class QuarantineSink;
+
+// A parser owns its scratch buffers and error counts, so one instance must not
+// be used from two threads at once: create one per thread instead. Instances
+// are cheap; the chunk parser behind parseAndSend is built on first use and
+// then reused, e.g. for every batch of appended lines while following.
 class VehicleDataParser {
 public:
-    static VehicleDataParser* getInstance();
-    bool parseLine(const std::string& line, VehicleData& data);
-    sendStatus parseAndSend();
-private:
-    VehicleDataParser() = default;
+    VehicleDataParser();
+    ~VehicleDataParser();
+    VehicleDataParser(VehicleDataParser&&) noexcept;
+    VehicleDataParser& operator=(VehicleDataParser&&) noexcept;
     VehicleDataParser(const VehicleDataParser&) = delete;
     VehicleDataParser& operator=(const VehicleDataParser&) = delete;
-    ~VehicleDataParser() = default;
+
+    // Compatibility shim: one process-wide instance for single-threaded callers.
+    static VehicleDataParser* getInstance();
+
+    // Tokenizes in place and never throws; data is only partially written on failure.
+    // Silent like decodeFields; the outcome is counted in errors().
+    ParseStatus parseLine(std::string_view line, VehicleData& data);
+    // Decodes fields already split by the caller (e.g. by LineFieldIterator).
+    // Silent; reporting the failure is left to the caller. Counted in errors().
+    ParseStatus decodeFields(const std::string_view* fields, size_t fieldCount, VehicleData& data);
+    // Sends every record in DATA_FILE_PATH. With follow set it then keeps
+    // tailing the file for appended lines until SIGINT/SIGTERM.
+    sendStatus parseAndSend(PartitionRouter& router, OutputWriter& out, bool follow = false);
+    // Rejected lines seen by parseAndSend go here; without one they are only
+    // reported to stderr, rate-limited the same way.
+    void setQuarantine(QuarantineSink* quarantine) { quarantine_ = quarantine; }
+
+    const ParseErrorCounts& errors() const { return errors_; }
+    void mergeErrors(const ParseErrorCounts& other) { errors_.merge(other); }
+    void resetErrors() { errors_ = ParseErrorCounts{}; }
+    // Separator offsets for scanSeparators, kept so chunk parsing does not reallocate.
+    std::vector<uint32_t>& separatorScratch() { return separators_; }
+
+private:
+    struct SendCounters {
+        size_t validCount = 0;
+        size_t invalidCount = 0;
+        size_t lineCount = 0;  // lines consumed so far, for error line numbers
+    };
+
+    bool sendContents(std::string_view contents, PartitionRouter& router, OutputWriter& out, SendCounters& counters,
+                      QuarantineSink& quarantine);
+    sendStatus followAppends(const std::string& path, uint64_t offset, PartitionRouter& router, OutputWriter& out,
+                             SendCounters& counters, QuarantineSink& quarantine);
+
+    ParseErrorCounts errors_;
+    std::vector<uint32_t> separators_;
+    std::unique_ptr<ParallelChunkParser> chunkParser_;
+    QuarantineSink* quarantine_ = nullptr;
 };
     
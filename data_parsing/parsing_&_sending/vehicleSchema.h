@@ -0,0 +1,43 @@
+#pragma once
+
+#include "string_parsing.h"
+#include "../common/recordSchema.h"
+
+// The telemetry line "vehicleId,timestamp,speed,engineOn,status" as a schema.
+// Both token tables list the spelling the feed normally uses first, since
+// that is the one encode() writes and the one decode() tries first. Unknown
+// statuses are not an error.
+inline constexpr TokenEntry<bool> kEngineTokens[] = {
+    {"1", true}, {"0", false}, {"ON", true}, {"OFF", false}, {"ENGINE_OK", true},
+};
+
+inline constexpr TokenEntry<EngineStatus> kStatusTokens[] = {
+    {"ENGINE_OK", EngineStatus::OK},
+    {"ENGINE_OVERHEAT", EngineStatus::E_Overheat},
+    {"ENGINE_SENSOR_FAIL", EngineStatus::E_SensorFailure},
+    {"OK", EngineStatus::OK},
+    {"SENSOR_FAILURE", EngineStatus::E_SensorFailure},
+};
+
+inline constexpr auto kVehicleSchema = makeRecordSchema<VehicleData, ','>(
+    schemaField<&VehicleData::vehicleId>("vehicleId", IntCodec{}),
+    schemaField<&VehicleData::timestampNs>("timestamp", TimestampCodec{}),
+    schemaField<&VehicleData::speed>("speed", DecimalCodec{}),
+    schemaField<&VehicleData::engineOn>("engineOn", tokenCodec(kEngineTokens)),
+    schemaField<&VehicleData::errorCode>("status",
+                                         tokenCodec(kStatusTokens).withFallback(EngineStatus::E_Unknown, "UNKNOWN")));
+
+// ParseStatus for a schema failure; the status field cannot fail.
+inline ParseStatus vehicleSchemaStatus(const SchemaDecodeResult& result) {
+    constexpr ParseStatus kFieldStatus[] = {
+        ParseStatus::E_InvalidId, ParseStatus::E_InvalidTimestamp, ParseStatus::E_InvalidSpeed,
+        ParseStatus::E_InvalidEngine, ParseStatus::E_OK,
+    };
+    static_assert(sizeof(kFieldStatus) / sizeof(kFieldStatus[0]) == kVehicleSchema.kFieldCount);
+    switch (result.error) {
+        case SchemaDecodeResult::Error::None: return ParseStatus::E_OK;
+        case SchemaDecodeResult::Error::FieldCount: return ParseStatus::E_FieldCount;
+        case SchemaDecodeResult::Error::Field: return kFieldStatus[result.field];
+    }
+    return ParseStatus::E_FieldCount;
+}
@@ -1,16 +1,73 @@
 #include "messageReceiver.h"
+#include "../common/partitioning.h"
+#include <fcntl.h>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
 
-int main() {
-    MessageReceiver receiver;
+int main(int argc, char** argv) {
+    TransportKind kind;
+    OutputOptions outputOptions;
+    AggregateOptions aggregateOptions;
+    TransportTuning tuning;
+    uint32_t partition = 0;
+    if (!transportKindFromArgs(argc, argv, kind) || !outputOptionsFromArgs(argc, argv, outputOptions) ||
+        !aggregateOptionsFromArgs(argc, argv, aggregateOptions) || !partitionIndexFromArgs(argc, argv, partition) ||
+        !transportTuningFromArgs(argc, argv, tuning)) {
+        return 1;
+    }
+    int snapshotFd = STDERR_FILENO;
+    if (!aggregateOptions.snapshotPath.empty()) {
+        snapshotFd = open(aggregateOptions.snapshotPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (snapshotFd == -1) {
+            perror("open snapshot file");
+            return 1;
+        }
+    }
+    OutputWriter out(STDOUT_FILENO, outputOptions);
+    auto transport = makeTransport(kind, TransportRole::Receiver, partition, tuning);
+    if (transport == nullptr) {
+        std::cerr << "Failed to open transport" << std::endl;
+        return 1;
+    }
+
+    MessageReceiver receiver(*transport, out);
+    VehicleAggregator aggregator;
+    std::unique_ptr<SnapshotPublisher> snapshots;
+    if (aggregateOptions.enabled) {
+        receiver.setAggregator(&aggregator);
+        snapshots = std::make_unique<SnapshotPublisher>(snapshotFd, outputOptions.format, aggregateOptions.interval);
+    }
     while (true) {
-        if (!receiver.receiveMessage()) {
+        if (!receiver.drainMessages()) {
             return 1;
         }
-        if (receiver.isMessageEmpty()) {
-            std::cout << "Empty message received. Exiting receiver." << std::endl;
+        receiver.printDrained();
+        if (receiver.isEndOfStream()) {
+            std::ostringstream summary;
+            summary << "End-of-stream message received. Exiting receiver.\n";
+            if (partition > 0) {
+                summary << "Partition: " << partition << '\n';
+            }
+            receiver.printStats(summary);
+            if (snapshots != nullptr) {
+                // The final snapshot covers every record; the destructor waits for it.
+                snapshots->publish(aggregator);
+                summary << "Vehicles aggregated: " << aggregator.vehicleCount() << ", snapshots: "
+                        << snapshots->published() << '\n';
+            }
+            out.append(summary.str());
             break;
         }
-        receiver.printMessage();
+        if (snapshots != nullptr) {
+            snapshots->publishIfDue(aggregator);
+        }
+        // Flush before going back to sleep; under load let the buffer fill.
+        if (receiver.caughtUp()) {
+            out.flush();
+        } else {
+            out.flushIfDue();
+        }
     }
     return 0;
 }
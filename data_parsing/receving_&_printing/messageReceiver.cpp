@@ -1,61 +1,155 @@
 #include "messageReceiver.h"
-#include <cerrno>
-#include <chrono>
-#include <thread>
+#include <algorithm>
+#include <cstdio>
 
-bool MessageReceiver::receiveMessage() {
-    key_t key = MSG_QUEUE_KEY;
-
-    int msgid = msgget(key, IPC_CREAT | 0666);  //0666 is for permission
-    if (msgid == -1) {
-        perror("msgget");
-        return false;
+bool MessageReceiver::drainMessages() {
+    messageEnds.clear();
+    size_t used = 0;
+    // Sleep in the kernel until the sender delivers; after that only take
+    // what is already queued. Only an explicit end-of-stream ends the run.
+    auto timeout = kWaitForever;
+    while (messageEnds.size() < kMaxDrainMessages) {
+        if (drainBuffer.size() < used + kMaxMsgPayload) {
+            drainBuffer.resize(used + kMaxMsgPayload);
+        }
+        size_t len = 0;
+        RecvStatus status = transport.receive(drainBuffer.data() + used, kMaxMsgPayload, len, timeout);
+        if (status == RecvStatus::E_Timeout) {
+            break;
+        }
+        if (status == RecvStatus::E_EndOfStream) {
+            endOfStream = true;
+            break;
+        }
+        if (status != RecvStatus::E_OK) {
+            return false;
+        }
+        used += len;
+        messageEnds.push_back(used);
+        timeout = std::chrono::milliseconds(0);
     }
 
-    constexpr int kPollSleepMs = 100;
-    constexpr int kMaxIdlePolls = 20;  // ~2 seconds total idle wait
-    int idlePolls = 0;
-
-    while (true) {
-        if (msgrcv(msgid, &msg, sizeof(msg.text), 0, IPC_NOWAIT) != -1) {
-            std::cout << "Received message successfully: " << msg.text << std::endl;
-            return true;
+    if (!messageEnds.empty()) {
+        lastReceive = std::chrono::steady_clock::now();
+        drainedAtNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(lastReceive.time_since_epoch()).count();
+        if (messagesReceived == 0) {
+            firstReceive = lastReceive;
         }
+        messagesReceived += messageEnds.size();
+        ++wakeups;
+        maxDrained = std::max(maxDrained, messageEnds.size());
+    }
+    return true;
+}
+
+void MessageReceiver::printDrained() {
+    if (messageEnds.empty()) {
+        return;
+    }
+    if (out.enabled(Verbosity::Verbose)) {
+        out.append("Received " + std::to_string(messageEnds.size()) + " message(s)\n");
+    }
+    size_t start = 0;
+    for (size_t end : messageEnds) {
+        appendRecords(drainBuffer.data() + start, end - start);
+        start = end;
+    }
+}
 
-        if (errno == ENOMSG) {
-            if (idlePolls >= kMaxIdlePolls) {
-                msg.text[0] = '\0';
-                return true;
+void MessageReceiver::appendRecords(const unsigned char* payload, size_t len) {
+    BatchInfo info;
+    if (!decodeBatch(payload, len, decoded, &info)) {
+        std::cerr << "Dropping undecodable message of " << len << " bytes\n";
+        return;
+    }
+    recordsReceived += decoded.size();
+    bytesReceived += len;
+    const bool print = out.enabled(Verbosity::Normal);
+    if (info.hasQueuedTime) {
+        // steady_clock is CLOCK_MONOTONIC, shared by every process on the host.
+        const int64_t latency = drainedAtNs - info.queuedNs;
+        bool anyFault = false;
+        for (const WireRecord& record : decoded) {
+            if (isFaultStatus(record.status)) {
+                faultLatency.add(latency);
+                anyFault = true;
             }
-            ++idlePolls;
-            std::this_thread::sleep_for(std::chrono::milliseconds(kPollSleepMs));
-            continue;
         }
-
-        if (errno == EINTR) {
-            continue;
+        if (!anyFault) {
+            routineLatency.add(latency);
+        }
+    }
+    for (const WireRecord& record : decoded) {
+        if (aggregator != nullptr) {
+            aggregator->update(record);
+        }
+        if (print) {
+            out.appendRecord(record);
         }
+    }
+}
 
-        perror("msgrcv");
-        return false;
+void MessageReceiver::printStats(std::ostream& os) const {
+    double seconds = std::chrono::duration<double>(lastReceive - firstReceive).count();
+    double perMessage = messagesReceived > 0 ? static_cast<double>(recordsReceived) / messagesReceived : 0.0;
+    double perWakeup = wakeups > 0 ? static_cast<double>(messagesReceived) / wakeups : 0.0;
+    os << "Messages received: " << messagesReceived << ", records: " << recordsReceived
+       << ", records/message: " << perMessage;
+    if (recordsReceived > 0) {
+        os << ", bytes/record: " << static_cast<double>(bytesReceived) / recordsReceived;
+    }
+    if (seconds > 0) {
+        os << ", messages/s: " << messagesReceived / seconds;
     }
+    os << '\n';
+    os << "Wakeups: " << wakeups << ", messages drained/wakeup: " << perWakeup << " (max " << maxDrained << ")\n";
+    printLatency(os, "fault records", faultLatency);
+    printLatency(os, "routine batches", routineLatency);
 }
 
-void MessageReceiver::printMessage() {
-    // This function can be expanded to format the message or extract specific fields if needed.
-    // For now, it simply prints the received message.
-    std::vector<std::string> fields;
-    std::string msgText(msg.text);
-    std::stringstream ss(msgText);
-    std::string field;
-    while (std::getline(ss, field, ',')) {
-        fields.push_back(field);
+void MessageReceiver::LatencySamples::add(int64_t ns) {
+    ++count;
+    max = count == 1 || ns > max ? ns : max;
+    if (samples.size() < kMaxLatencySamples) {
+        samples.push_back(ns);
+        return;
+    }
+    // Keep the new sample with probability kMaxLatencySamples / count (xorshift64).
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    const uint64_t slot = rng % count;
+    if (slot < kMaxLatencySamples) {
+        samples[slot] = ns;
     }
-    for (const auto& f : fields) {
-        std::cout << "Field: " << f << std::endl;
+}
+
+MessageReceiver::LatencyStats MessageReceiver::latencyStats(const LatencySamples& latency) {
+    LatencyStats stats;
+    stats.count = latency.count;
+    if (latency.count == 0) {
+        return stats;
     }
+    std::vector<int64_t> samples = latency.samples;
+    auto at = [&](double p) {
+        size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index] / 1000.0;
+    };
+    stats.p50Us = at(0.50);
+    stats.p99Us = at(0.99);
+    stats.maxUs = latency.max / 1000.0;
+    return stats;
 }
 
-bool MessageReceiver::isMessageEmpty() const {
-    return msg.text[0] == '\0';
+void MessageReceiver::printLatency(std::ostream& os, const char* label, const LatencySamples& latency) {
+    if (latency.count == 0) {
+        return;
+    }
+    const LatencyStats stats = latencyStats(latency);
+    char line[160];
+    std::snprintf(line, sizeof(line), "Latency %s: n=%zu, p50 %.1f us, p99 %.1f us, max %.1f us\n", label,
+                  stats.count, stats.p50Us, stats.p99Us, stats.maxUs);
+    os << line;
 }
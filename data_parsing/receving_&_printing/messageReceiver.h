@@ -1,22 +1,83 @@
+#pragma once
+
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
-#include <sys/ipc.h>
-#include <sys/msg.h>
-
-constexpr key_t MSG_QUEUE_KEY = 0x2222;
-
-struct Msg {
-    long type;
-    char text[256];
-};
+#include "../common/batchCodec.h"
+#include "../common/outputWriter.h"
+#include "../common/transport.h"
+#include "../common/vehicleWire.h"
+#include "vehicleAggregator.h"
 
 class MessageReceiver {
 public:
-    bool receiveMessage();
-    void printMessage();
-    bool isMessageEmpty() const;
+    MessageReceiver(Transport& transport, OutputWriter& out) : transport(transport), out(out) {}
+    // Sleeps until at least one message arrives, then pulls every message that
+    // is already queued (up to kMaxDrainMessages) into a reusable buffer.
+    bool drainMessages();
+    // Decodes everything drained by the last call into the output buffer and,
+    // if one is attached, the per-vehicle aggregator.
+    void printDrained();
+    void setAggregator(VehicleAggregator* aggregator) { this->aggregator = aggregator; }
+    // True if the last drain emptied the queue, i.e. the receiver is about to sleep.
+    bool caughtUp() const { return messageEnds.size() < kMaxDrainMessages; }
+    bool isEndOfStream() const { return endOfStream; }
+    // Messages/records received so far, batch sizes, messages drained per
+    // wakeup, and queued-to-received latency with fault records kept apart
+    // from routine batches.
+    void printStats(std::ostream& os) const;
+
+    // Latency percentiles over the kept samples; count and max are exact.
+    struct LatencyStats {
+        size_t count = 0;
+        double p50Us = 0;
+        double p99Us = 0;
+        double maxUs = 0;
+    };
+    size_t messageCount() const { return messagesReceived; }
+    size_t recordCount() const { return recordsReceived; }
+    size_t byteCount() const { return bytesReceived; }
+    LatencyStats faultLatencyStats() const { return latencyStats(faultLatency); }
+    LatencyStats routineLatencyStats() const { return latencyStats(routineLatency); }
+
+    static constexpr size_t kMaxDrainMessages = 256;
+    // Latency samples kept per series; a long --follow run keeps a uniform
+    // sample of everything seen instead of growing without bound.
+    static constexpr size_t kMaxLatencySamples = 1 << 16;
+
 private:
-    Msg msg{};
+    // Reservoir sample (Algorithm R) of latencies, plus the exact count and max.
+    struct LatencySamples {
+        std::vector<int64_t> samples;
+        size_t count = 0;
+        int64_t max = 0;
+        uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+        void add(int64_t ns);
+    };
+
+    void appendRecords(const unsigned char* payload, size_t len);
+    static LatencyStats latencyStats(const LatencySamples& latency);
+    static void printLatency(std::ostream& os, const char* label, const LatencySamples& latency);
+
+    Transport& transport;
+    OutputWriter& out;
+    VehicleAggregator* aggregator = nullptr;
+    // Drained payloads are packed back to back; messageEnds[i] is where message i stops.
+    std::vector<unsigned char> drainBuffer;
+    std::vector<size_t> messageEnds;
+    std::vector<WireRecord> decoded;  // reused across messages
+    int64_t drainedAtNs = 0;          // CLOCK_MONOTONIC time of the last drain
+    LatencySamples faultLatency;    // one sample per fault record
+    LatencySamples routineLatency;  // one sample per routine message
+    bool endOfStream = false;
+    size_t messagesReceived = 0;
+    size_t recordsReceived = 0;
+    size_t bytesReceived = 0;
+    size_t wakeups = 0;
+    size_t maxDrained = 0;
+    std::chrono::steady_clock::time_point firstReceive{};
+    std::chrono::steady_clock::time_point lastReceive{};
 };
@@ -0,0 +1,260 @@
+#include "vehicleAggregator.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+
+namespace {
+
+constexpr const char* kStatusNames[kEngineStatusCount] = {"ok", "invalidFormat", "sensorFailure", "overheat",
+                                                          "unknown"};
+
+// Shortest round-trip form, as in OutputWriter's machine-readable formats.
+template <typename T>
+void appendNumber(std::string& out, T value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+size_t roundUpPow2(size_t n) {
+    size_t p = 16;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+bool parseMillis(std::string_view text, std::chrono::milliseconds& value) {
+    long long ms = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), ms);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size() || ms <= 0) {
+        return false;
+    }
+    value = std::chrono::milliseconds(ms);
+    return true;
+}
+
+}  // namespace
+
+VehicleAggregator::VehicleAggregator(size_t initialCapacity) {
+    slots_.resize(roundUpPow2(initialCapacity));
+    mask_ = slots_.size() - 1;
+}
+
+size_t VehicleAggregator::slotFor(int32_t vehicleId) const {
+    // Fibonacci hashing: sequential ids spread across the table instead of
+    // forming one long probe run.
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(vehicleId)) * 0x9E3779B97F4A7C15ull;
+    size_t slot = static_cast<size_t>(h >> 32) & mask_;
+    while (slots_[slot].count != 0 && slots_[slot].vehicleId != vehicleId) {
+        slot = (slot + 1) & mask_;
+    }
+    return slot;
+}
+
+void VehicleAggregator::grow() {
+    std::vector<VehicleStats> old(slots_.size() * 2);
+    old.swap(slots_);
+    mask_ = slots_.size() - 1;
+    for (size_t& index : occupied_) {
+        const VehicleStats& stats = old[index];
+        index = slotFor(stats.vehicleId);
+        slots_[index] = stats;
+    }
+}
+
+void VehicleAggregator::update(const WireRecord& record) {
+    size_t slot = slotFor(record.vehicleId);
+    VehicleStats* stats = &slots_[slot];
+    if (stats->count == 0) {
+        if ((size_ + 1) * 10 > slots_.size() * 7) {
+            grow();
+            slot = slotFor(record.vehicleId);
+            stats = &slots_[slot];
+        }
+        occupied_.push_back(slot);
+        stats->vehicleId = record.vehicleId;
+        stats->minSpeed = record.speed;
+        stats->maxSpeed = record.speed;
+        ++size_;
+    }
+    ++stats->count;
+    stats->minSpeed = std::min(stats->minSpeed, record.speed);
+    stats->maxSpeed = std::max(stats->maxSpeed, record.speed);
+    stats->sumSpeed += record.speed;
+    stats->engineOnCount += record.engineOn ? 1 : 0;
+    size_t status = static_cast<size_t>(record.status);
+    ++stats->statusCounts[status < kEngineStatusCount ? status : kEngineStatusCount - 1];
+    ++records_;
+}
+
+const VehicleStats* VehicleAggregator::find(int32_t vehicleId) const {
+    const VehicleStats& stats = slots_[slotFor(vehicleId)];
+    return stats.count != 0 ? &stats : nullptr;
+}
+
+void VehicleAggregator::snapshot(std::vector<VehicleStats>& out) const {
+    out.resize(occupied_.size());
+    for (size_t i = 0; i < occupied_.size(); ++i) {
+        out[i] = slots_[occupied_[i]];
+    }
+}
+
+void appendVehicleStats(std::string& out, const VehicleStats& stats, OutputFormat format, uint64_t snapshotId) {
+    if (format == OutputFormat::Human) {
+        out += "Vehicle ";
+        appendNumber(out, stats.vehicleId);
+        out += ": records:";
+        appendNumber(out, stats.count);
+        out += " speed min/mean/max:";
+        appendFixed(out, stats.minSpeed, 2);
+        out += '/';
+        appendFixed(out, stats.meanSpeed(), 2);
+        out += '/';
+        appendFixed(out, stats.maxSpeed, 2);
+        out += " engineOn:";
+        appendFixed(out, stats.engineOnRatio() * 100.0, 1);
+        out += "% overheat:";
+        appendNumber(out, stats.statusCounts[static_cast<size_t>(EngineStatus::E_Overheat)]);
+        out += " sensorFailure:";
+        appendNumber(out, stats.statusCounts[static_cast<size_t>(EngineStatus::E_SensorFailure)]);
+        out += " unknown:";
+        appendNumber(out, stats.statusCounts[static_cast<size_t>(EngineStatus::E_Unknown)]);
+        out += '\n';
+        return;
+    }
+
+    const bool csv = format == OutputFormat::Csv;
+    const double values[] = {stats.minSpeed, stats.meanSpeed(), stats.maxSpeed, stats.engineOnRatio()};
+    const char* const names[] = {"minSpeed", "meanSpeed", "maxSpeed", "engineOnRatio"};
+    if (csv) {
+        appendNumber(out, snapshotId);
+        out += ',';
+        appendNumber(out, stats.vehicleId);
+        out += ',';
+        appendNumber(out, stats.count);
+    } else {
+        out += "{\"snapshot\":";
+        appendNumber(out, snapshotId);
+        out += ",\"vehicleId\":";
+        appendNumber(out, stats.vehicleId);
+        out += ",\"records\":";
+        appendNumber(out, stats.count);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        if (csv) {
+            out += ',';
+        } else {
+            out += ",\"";
+            out += names[i];
+            out += "\":";
+        }
+        appendNumber(out, values[i]);
+    }
+    if (!csv) {
+        out += ",\"status\":{";
+    }
+    for (size_t i = 0; i < kEngineStatusCount; ++i) {
+        if (csv) {
+            out += ',';
+        } else {
+            out += i == 0 ? "\"" : ",\"";
+            out += kStatusNames[i];
+            out += "\":";
+        }
+        appendNumber(out, stats.statusCounts[i]);
+    }
+    out += csv ? "\n" : "}}\n";
+}
+
+bool aggregateOptionsFromArgs(int argc, char** argv, AggregateOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg == "--aggregate") {
+            options.enabled = true;
+        } else if (arg.substr(0, 20) == "--snapshot-interval=") {
+            if (!parseMillis(arg.substr(20), options.interval)) {
+                std::cerr << "Invalid snapshot interval: " << arg.substr(20) << std::endl;
+                return false;
+            }
+            options.enabled = true;
+        } else if (arg.substr(0, 16) == "--snapshot-file=") {
+            options.snapshotPath = std::string(arg.substr(16));
+            options.enabled = true;
+        }
+    }
+    return true;
+}
+
+SnapshotPublisher::SnapshotPublisher(int fd, OutputFormat format, std::chrono::milliseconds interval)
+    : out_(fd, OutputOptions{format, Verbosity::Normal, false}),
+      format_(format),
+      interval_(interval),
+      last_(Clock::now()),
+      thread_(&SnapshotPublisher::publisherLoop, this) {}
+
+SnapshotPublisher::~SnapshotPublisher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void SnapshotPublisher::publishIfDue(const VehicleAggregator& aggregator) {
+    if (Clock::now() - last_ >= interval_) {
+        publish(aggregator);
+    }
+}
+
+void SnapshotPublisher::publish(const VehicleAggregator& aggregator) {
+    last_ = Clock::now();
+    // Copy outside the lock; the helper only holds it to swap buffers.
+    aggregator.snapshot(spare_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.swap(spare_);
+        pendingId_ = ++published_;
+        hasPending_ = true;
+    }
+    cv_.notify_one();
+}
+
+void SnapshotPublisher::publisherLoop() {
+    std::vector<VehicleStats> work;
+    std::string text;
+    bool csvHeaderWritten = false;
+    while (true) {
+        uint64_t id = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return hasPending_ || stop_; });
+            if (!hasPending_) {
+                return;
+            }
+            work.swap(pending_);
+            id = pendingId_;
+            hasPending_ = false;
+        }
+        std::sort(work.begin(), work.end(),
+                  [](const VehicleStats& a, const VehicleStats& b) { return a.vehicleId < b.vehicleId; });
+        text.clear();
+        if (format_ == OutputFormat::Human) {
+            text += "Snapshot " + std::to_string(id) + ": " + std::to_string(work.size()) + " vehicle(s)\n";
+        } else if (format_ == OutputFormat::Csv && !csvHeaderWritten) {
+            csvHeaderWritten = true;
+            text += "snapshot,vehicleId,records,minSpeed,meanSpeed,maxSpeed,engineOnRatio";
+            for (const char* name : kStatusNames) {
+                text += ',';
+                text += name;
+            }
+            text += '\n';
+        }
+        for (const VehicleStats& stats : work) {
+            appendVehicleStats(text, stats, format_, id);
+        }
+        out_.append(text);
+        out_.flush();
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../common/outputWriter.h"
+#include "../common/vehicleWire.h"
+
+constexpr size_t kEngineStatusCount = static_cast<size_t>(EngineStatus::E_Unknown) + 1;
+
+// Running totals for one vehicle. count == 0 marks an empty hash slot.
+struct VehicleStats {
+    int32_t vehicleId = 0;
+    uint64_t count = 0;
+    double minSpeed = 0.0;
+    double maxSpeed = 0.0;
+    double sumSpeed = 0.0;
+    uint64_t engineOnCount = 0;
+    uint64_t statusCounts[kEngineStatusCount] = {};
+
+    double meanSpeed() const { return count > 0 ? sumSpeed / count : 0.0; }
+    double engineOnRatio() const { return count > 0 ? static_cast<double>(engineOnCount) / count : 0.0; }
+};
+
+// Per-vehicle aggregates in an open-addressing table keyed by vehicleId
+// (linear probing, power-of-two capacity, grown at 70% load), so each
+// record costs one hash and usually one cache line. The occupied slots are
+// also listed, so a snapshot costs one copy per vehicle, not per slot.
+class VehicleAggregator {
+public:
+    explicit VehicleAggregator(size_t initialCapacity = 1024);
+
+    void update(const WireRecord& record);
+    // nullptr if the vehicle has not been seen.
+    const VehicleStats* find(int32_t vehicleId) const;
+    size_t vehicleCount() const { return size_; }
+    uint64_t recordCount() const { return records_; }
+    // Copies every vehicle's stats into out, in first-seen order.
+    void snapshot(std::vector<VehicleStats>& out) const;
+
+private:
+    size_t slotFor(int32_t vehicleId) const;
+    void grow();
+
+    std::vector<VehicleStats> slots_;
+    std::vector<size_t> occupied_;  // slot indexes in first-seen order
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    uint64_t records_ = 0;
+};
+
+// Renders one vehicle's aggregates in the given output format.
+void appendVehicleStats(std::string& out, const VehicleStats& stats, OutputFormat format, uint64_t snapshotId);
+
+struct AggregateOptions {
+    bool enabled = false;
+    std::chrono::milliseconds interval{1000};
+    std::string snapshotPath;  // empty means stderr
+};
+
+// Reads --aggregate, --snapshot-interval=<ms> and --snapshot-file=<path>.
+// Returns false on a malformed value.
+bool aggregateOptionsFromArgs(int argc, char** argv, AggregateOptions& options);
+
+// Emits periodic aggregate snapshots from a helper thread. The ingest thread
+// only copies the table (a few bytes per vehicle) into a spare buffer; sorting,
+// formatting and the write happen off the receive path. If the helper is still
+// busy, the newer snapshot replaces the one it has not started yet.
+class SnapshotPublisher {
+public:
+    SnapshotPublisher(int fd, OutputFormat format, std::chrono::milliseconds interval);
+    ~SnapshotPublisher();
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Publishes if the interval has elapsed since the last snapshot.
+    void publishIfDue(const VehicleAggregator& aggregator);
+    void publish(const VehicleAggregator& aggregator);
+    uint64_t published() const { return published_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void publisherLoop();
+
+    OutputWriter out_;
+    OutputFormat format_;
+    std::chrono::milliseconds interval_;
+    Clock::time_point last_;
+    uint64_t published_ = 0;
+
+    std::vector<VehicleStats> spare_;
+    std::vector<VehicleStats> pending_;
+    uint64_t pendingId_ = 0;
+    bool hasPending_ = false;
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
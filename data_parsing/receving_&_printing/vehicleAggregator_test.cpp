@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include "vehicleAggregator.h"
+
+int main() {
+    std::cout << "[Test] starting vehicle aggregator tests\n";
+
+    // Test 1: aggregates match a naive map, across several table growths.
+    {
+        VehicleAggregator aggregator(16);
+        std::map<int32_t, VehicleStats> expected;
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int32_t> pickId(-500, 5000);
+        std::uniform_real_distribution<double> pickSpeed(0.0, 200.0);
+        for (int i = 0; i < 200000; ++i) {
+            WireRecord r{pickId(rng), i, pickSpeed(rng), (i & 1) != 0, static_cast<EngineStatus>(i % 5)};
+            aggregator.update(r);
+            VehicleStats& s = expected[r.vehicleId];
+            if (s.count == 0) {
+                s.vehicleId = r.vehicleId;
+                s.minSpeed = s.maxSpeed = r.speed;
+            }
+            ++s.count;
+            s.minSpeed = std::min(s.minSpeed, r.speed);
+            s.maxSpeed = std::max(s.maxSpeed, r.speed);
+            s.sumSpeed += r.speed;
+            s.engineOnCount += r.engineOn;
+            ++s.statusCounts[i % 5];
+        }
+        assert(aggregator.vehicleCount() == expected.size());
+        assert(aggregator.recordCount() == 200000);
+        for (const auto& [id, want] : expected) {
+            const VehicleStats* got = aggregator.find(id);
+            assert(got != nullptr && got->count == want.count && got->minSpeed == want.minSpeed &&
+                   got->maxSpeed == want.maxSpeed && got->sumSpeed == want.sumSpeed &&
+                   got->engineOnCount == want.engineOnCount);
+            for (size_t s = 0; s < kEngineStatusCount; ++s) {
+                assert(got->statusCounts[s] == want.statusCounts[s]);
+            }
+        }
+        assert(aggregator.find(999999) == nullptr);
+        std::vector<VehicleStats> snap;
+        aggregator.snapshot(snap);
+        assert(snap.size() == expected.size());
+        for (const VehicleStats& stats : snap) {
+            assert(stats.count == expected[stats.vehicleId].count);
+        }
+        std::cout << "[Test1] " << expected.size() << " vehicles ok\n";
+    }
+
+    // Test 2: published snapshots reach the fd, sorted by vehicle id.
+    {
+        int fds[2];
+        assert(pipe(fds) == 0);
+        VehicleAggregator aggregator;
+        aggregator.update(WireRecord{1002, 0, 50.0, true, EngineStatus::OK});
+        aggregator.update(WireRecord{1001, 0, 70.0, false, EngineStatus::E_Overheat});
+        aggregator.update(WireRecord{1001, 0, 90.0, true, EngineStatus::OK});
+        {
+            SnapshotPublisher publisher(fds[1], OutputFormat::JsonLines, std::chrono::milliseconds(1000));
+            publisher.publish(aggregator);
+        }
+        close(fds[1]);
+        std::string text;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+            text.append(buf, static_cast<size_t>(n));
+        }
+        close(fds[0]);
+        size_t first = text.find("\"vehicleId\":1001");
+        size_t second = text.find("\"vehicleId\":1002");
+        assert(first != std::string::npos && second != std::string::npos && first < second);
+        assert(text.find("\"records\":2,\"minSpeed\":70,\"meanSpeed\":80,\"maxSpeed\":90") != std::string::npos);
+        assert(text.find("\"overheat\":1") != std::string::npos);
+        std::cout << "[Test2] snapshot output ok\n";
+    }
+
+    // Test 3: a human row is never cut short, however large the speeds.
+    {
+        VehicleStats stats;
+        stats.vehicleId = 7;
+        stats.count = 2;
+        stats.minSpeed = 1.005;
+        stats.maxSpeed = 1e300;
+        stats.sumSpeed = 1e300;
+        stats.engineOnCount = 1;
+        stats.statusCounts[static_cast<size_t>(EngineStatus::E_Unknown)] = 2;
+        std::string row;
+        appendVehicleStats(row, stats, OutputFormat::Human, 1);
+        char maxSpeed[400];
+        std::snprintf(maxSpeed, sizeof(maxSpeed), "%.2f", 1e300);
+        assert(row.compare(0, 43, "Vehicle 7: records:2 speed min/mean/max:1.0") == 0);
+        assert(row.find(std::string("/") + maxSpeed + " engineOn:50.0% overheat:0 sensorFailure:0 unknown:2\n") !=
+               std::string::npos);
+        assert(row.back() == '\n' && row.size() > 2 * 300);
+        std::cout << "[Test3] human row ok\n";
+    }
+
+    std::cout << "[Test] all vehicle aggregator tests passed\n";
+    return 0;
+}
@@ -0,0 +1,161 @@
+// codecBench: compression ratio and speed of the batch encodings.
+//
+// Reads a data file (or synthesizes a feed with rising ids and timestamps,
+// slowly varying speeds and mostly ENGINE_OK), cuts it into batches the way
+// MessageBatcher does for the given message size, and times encode and
+// decode for each encoding. One JSON object is printed per encoding.
+//
+// Usage: codecBench [--records=N] [--size=BYTES] [file]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../common/batchCodec.h"
+#include "../common/timestamp.h"
+#include "../parsing_&_sending/columnStore.h"
+#include "../parsing_&_sending/mappedFile.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRepeats = 20;
+
+std::vector<WireRecord> synthesize(size_t count) {
+    std::mt19937 rng(42);
+    std::vector<WireRecord> records;
+    records.reserve(count);
+    int64_t ts = 1771064123LL * kNanosPerSecond;
+    double speed = 80.0;
+    for (size_t i = 0; i < count; ++i) {
+        ts += kNanosPerSecond / 10;
+        speed = std::round((speed + (static_cast<int>(rng() % 21) - 10) / 10.0) * 10.0) / 10.0;
+        EngineStatus status = rng() % 100 == 0 ? EngineStatus::E_Overheat : EngineStatus::OK;
+        records.push_back(WireRecord{static_cast<int32_t>(1000 + i % 64), ts, speed, rng() % 20 != 0, status});
+    }
+    return records;
+}
+
+std::vector<WireRecord> loadFile(const std::string& path) {
+    std::vector<WireRecord> records;
+    MappedFile file;
+    if (!file.open(path)) {
+        return records;
+    }
+    VehicleColumnStore store;
+    VehicleDataParser parser;
+    store.load(file.view(), parser);
+    for (size_t i = 0; i < store.size(); ++i) {
+        VehicleData d = store.row(i);
+        records.push_back(WireRecord{d.vehicleId, d.timestampNs, d.speed, d.engineOn, d.errorCode});
+    }
+    return records;
+}
+
+// Splits records into message payloads no larger than messageBytes.
+std::vector<std::vector<unsigned char>> encodeAll(const std::vector<WireRecord>& records, BatchEncoding encoding,
+                                                  size_t messageBytes) {
+    std::vector<std::vector<unsigned char>> messages;
+    if (encoding == BatchEncoding::Fixed) {
+        size_t perMessage = (messageBytes - kBatchHeaderSize) / kWireRecordSize;
+        for (size_t i = 0; i < records.size(); i += perMessage) {
+            size_t n = std::min(perMessage, records.size() - i);
+            std::vector<unsigned char> payload(kBatchHeaderSize + n * kWireRecordSize);
+            encodeBatchHeader(static_cast<uint16_t>(n), payload.data());
+            for (size_t j = 0; j < n; ++j) {
+                encodeRecord(records[i + j], payload.data() + kBatchHeaderSize + j * kWireRecordSize,
+                             kWireRecordSize);
+            }
+            messages.push_back(std::move(payload));
+        }
+        return messages;
+    }
+    DeltaBatchEncoder encoder;
+    auto emit = [&] {
+        std::vector<unsigned char> payload(encoder.encodedSize());
+        encoder.finish(payload.data(), payload.size());
+        messages.push_back(std::move(payload));
+        encoder.reset();
+    };
+    for (const WireRecord& r : records) {
+        if (encoder.count() > 0 && (encoder.sizeWith(r) > messageBytes || encoder.count() == UINT16_MAX)) {
+            emit();
+        }
+        encoder.add(r);
+    }
+    if (encoder.count() > 0) {
+        emit();
+    }
+    return messages;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 1000000;
+    size_t messageBytes = 8192;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.rfind("--records=", 0) == 0) {
+            count = std::stoul(std::string(arg.substr(10)));
+        } else if (arg.rfind("--size=", 0) == 0) {
+            messageBytes = std::stoul(std::string(arg.substr(7)));
+        } else {
+            path = std::string(arg);
+        }
+    }
+    if (messageBytes < kBatchHeaderSize + 64 || messageBytes > kMaxMsgPayload) {
+        std::fprintf(stderr, "--size must be between %zu and %zu\n", kBatchHeaderSize + 64, kMaxMsgPayload);
+        return 1;
+    }
+    std::vector<WireRecord> records = path.empty() ? synthesize(count) : loadFile(path);
+    if (records.empty()) {
+        std::fprintf(stderr, "no records\n");
+        return 1;
+    }
+
+    const size_t rawBytes = records.size() * kWireRecordSize;
+    for (BatchEncoding encoding : {BatchEncoding::Fixed, BatchEncoding::Delta}) {
+        std::vector<std::vector<unsigned char>> messages;
+        auto start = Clock::now();
+        for (int r = 0; r < kRepeats; ++r) {
+            messages = encodeAll(records, encoding, messageBytes);
+        }
+        double encodeSeconds = std::chrono::duration<double>(Clock::now() - start).count() / kRepeats;
+
+        size_t bytes = 0;
+        for (const auto& m : messages) {
+            bytes += m.size();
+        }
+        std::vector<WireRecord> decoded;
+        size_t decodedCount = 0;
+        start = Clock::now();
+        for (int r = 0; r < kRepeats; ++r) {
+            for (const auto& m : messages) {
+                if (!decodeBatch(m.data(), m.size(), decoded)) {
+                    std::fprintf(stderr, "decode failed\n");
+                    return 1;
+                }
+                decodedCount += decoded.size();
+            }
+        }
+        double decodeSeconds = std::chrono::duration<double>(Clock::now() - start).count() / kRepeats;
+        if (decodedCount != records.size() * kRepeats) {
+            std::fprintf(stderr, "record count mismatch\n");
+            return 1;
+        }
+
+        // Throughput is quoted in fixed-layout bytes so both encodings are comparable.
+        std::printf("{\"encoding\":\"%s\",\"records\":%zu,\"messages\":%zu,\"bytes\":%zu,\"bytesPerRecord\":%.2f,"
+                    "\"ratio\":%.2f,\"encodeMBps\":%.1f,\"decodeMBps\":%.1f}\n",
+                    batchEncodingToString(encoding), records.size(), messages.size(), bytes,
+                    static_cast<double>(bytes) / records.size(), static_cast<double>(rawBytes) / bytes,
+                    rawBytes / encodeSeconds / 1e6, rawBytes / decodeSeconds / 1e6);
+    }
+    return 0;
+}
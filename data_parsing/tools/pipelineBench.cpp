@@ -0,0 +1,386 @@
+// pipelineBench: end-to-end throughput of the vehicle pipeline, stage by stage.
+//
+// Writes a synthetic feed of N records (a fraction of them malformed) to a
+// temporary file, or uses the given file, then runs the real sender and
+// receiver code over one transport:
+//   read     mmap the file and fault in every page
+//   parse    ParallelChunkParser over the mapping into WireRecords
+//   encode   MessageBatcher batching/encoding (time outside Transport::send)
+//   send     time inside Transport::send / sendPriority
+//   receive  MessageReceiver: first message to end of stream
+//   decode+output  MessageReceiver::printDrained, decodeBatch plus
+//            OutputWriter formatting to /dev/null
+// The sender stages run one after another, not overlapped, so each rate is
+// that stage's own. End-to-end latency is the receiver's own (routine
+// batches and fault records), from the queued-time trailer every batch
+// carries (CLOCK_MONOTONIC, same host). One JSON object is printed.
+//
+// Usage: pipelineBench [--records=N] [--malformed=RATIO] [--transport=<name>]
+//                      [--encoding=fixed|delta] [--format=human|csv|json] [file]
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "../common/batchCodec.h"
+#include "../common/outputWriter.h"
+#include "../common/timestamp.h"
+#include "../common/transport.h"
+#include "../parsing_&_sending/mappedFile.h"
+#include "../parsing_&_sending/messageBatcher.h"
+#include "../parsing_&_sending/parallelParser.h"
+#include "../receving_&_printing/messageReceiver.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double toSeconds(Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+// Same line shapes as vehicle_data.txt, including its malformed cases.
+bool writeFeed(const std::string& path, size_t records, double malformedRatio) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        perror("fopen");
+        return false;
+    }
+    static const char* const kMalformed[] = {
+        "1011,INVALID_DATA",
+        "1012,2026-02-14 10:24:55,abc,1,ENGINE_OK",
+        ",2026-02-14 10:25:12,77.3,1,ENGINE_OK",
+        "1013,2026-02-14 10:26:30,98.2,2,ENGINE_OK",
+    };
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    int64_t ts = 1771064123LL * kNanosPerSecond;
+    double speed = 80.0;
+    char stamp[kTimestampTextLen + 1];
+    for (size_t i = 0; i < records; ++i) {
+        if (unit(rng) < malformedRatio) {
+            std::fprintf(file, "%s\n", kMalformed[rng() % 4]);
+            continue;
+        }
+        ts += kNanosPerSecond / 10;
+        speed = std::clamp(speed + (static_cast<int>(rng() % 21) - 10) / 10.0, 0.0, 200.0);
+        formatTimestamp(ts, stamp);
+        const uint64_t roll = rng() % 1000;
+        const char* status = roll < 2 ? "ENGINE_OVERHEAT" : roll < 3 ? "ENGINE_SENSOR_FAIL" : "ENGINE_OK";
+        std::fprintf(file, "%zu,%s,%.1f,%d,%s\n", 1000 + i % 1000, stamp, speed, rng() % 20 != 0, status);
+    }
+    return std::fclose(file) == 0;
+}
+
+// Forwards to the real transport and accumulates the time spent in sends.
+class TimedTransport : public Transport {
+public:
+    explicit TimedTransport(Transport& inner) : inner_(inner) {}
+
+    bool send(const unsigned char* data, size_t len) override {
+        auto start = Clock::now();
+        bool ok = inner_.send(data, len);
+        sendTime_ += Clock::now() - start;
+        return ok;
+    }
+    bool sendPriority(const unsigned char* data, size_t len) override {
+        auto start = Clock::now();
+        bool ok = inner_.sendPriority(data, len);
+        sendTime_ += Clock::now() - start;
+        return ok;
+    }
+    bool sendEndOfStream() override { return inner_.sendEndOfStream(); }
+    RecvStatus receive(unsigned char* buf, size_t cap, size_t& len, std::chrono::milliseconds timeout) override {
+        return inner_.receive(buf, cap, len, timeout);
+    }
+    size_t maxMessageSize() const override { return inner_.maxMessageSize(); }
+    const char* name() const override { return inner_.name(); }
+
+    Clock::duration sendTime() const { return sendTime_; }
+
+private:
+    Transport& inner_;
+    Clock::duration sendTime_{};
+};
+
+// Receiver results, passed back from the child over a pipe.
+struct ReceiverResult {
+    uint64_t messages = 0;
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    double receiveSeconds = 0;
+    double decodeOutputSeconds = 0;
+    MessageReceiver::LatencyStats routineLatency;
+    MessageReceiver::LatencyStats faultLatency;
+    bool ok = false;
+};
+
+ReceiverResult runReceiver(TransportKind kind, const OutputOptions& outputOptions, int readyFd) {
+    ReceiverResult result;
+    auto transport = makeTransport(kind, TransportRole::Receiver);
+    if (transport == nullptr) {
+        return result;
+    }
+    std::vector<unsigned char> buf(kMaxMsgPayload);
+    size_t len = 0;
+    // Drop anything a previous run left in a persistent queue.
+    RecvStatus status;
+    do {
+        status = transport->receive(buf.data(), buf.size(), len, std::chrono::milliseconds(0));
+    } while (status == RecvStatus::E_OK || status == RecvStatus::E_EndOfStream);
+    char ready = 1;
+    if (write(readyFd, &ready, 1) != 1) {
+        return result;
+    }
+
+    int devNull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    OutputWriter out(devNull, outputOptions);
+    MessageReceiver receiver(*transport, out);
+    Clock::duration decodeOutputTime{};
+    Clock::time_point first{};
+    // The same loop as the receiver's main().
+    while (true) {
+        if (!receiver.drainMessages()) {
+            close(devNull);
+            return result;
+        }
+        const auto drained = Clock::now();
+        if (first == Clock::time_point{} && receiver.messageCount() > 0) {
+            first = drained;
+        }
+        receiver.printDrained();
+        if (!receiver.isEndOfStream() && receiver.caughtUp()) {
+            out.flushIfDue();
+        }
+        decodeOutputTime += Clock::now() - drained;
+        if (receiver.isEndOfStream()) {
+            break;
+        }
+    }
+    const auto flushStart = Clock::now();
+    out.flush();
+    decodeOutputTime += Clock::now() - flushStart;
+    close(devNull);
+
+    result.messages = receiver.messageCount();
+    result.records = receiver.recordCount();
+    result.bytes = receiver.byteCount();
+    result.receiveSeconds = result.messages > 0 ? secondsSince(first) : 0.0;
+    result.decodeOutputSeconds = toSeconds(decodeOutputTime);
+    result.routineLatency = receiver.routineLatencyStats();
+    result.faultLatency = receiver.faultLatencyStats();
+    result.ok = true;
+    return result;
+}
+
+struct SenderResult {
+    uint64_t fileBytes = 0;
+    uint64_t lines = 0;
+    uint64_t records = 0;
+    uint64_t rejected = 0;
+    uint64_t messages = 0;
+    uint64_t bytesSent = 0;
+    double readSeconds = 0;
+    double parseSeconds = 0;
+    double encodeSeconds = 0;
+    double sendSeconds = 0;
+};
+
+bool runSender(TransportKind kind, BatchEncoding encoding, const std::string& path, SenderResult& result) {
+    auto start = Clock::now();
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+    std::string_view contents = file.view();
+    // Touch every page so the parse stage does not pay for page faults.
+    volatile unsigned char sink = 0;
+    for (size_t i = 0; i < contents.size(); i += 4096) {
+        sink = sink + static_cast<unsigned char>(contents[i]);
+    }
+    result.readSeconds = secondsSince(start);
+    result.fileBytes = contents.size();
+
+    start = Clock::now();
+    VehicleDataParser parser;
+    ParallelChunkParser chunkParser(parser);
+    std::vector<WireRecord> records;
+    chunkParser.run(contents, [&](const ParsedChunk& chunk, size_t) {
+        result.lines += chunk.lineCount;
+        for (size_t i = 0; i < chunk.recordCount; ++i) {
+            const VehicleData& d = chunk.records[i];
+            records.push_back(WireRecord{d.vehicleId, d.timestampNs, d.speed, d.engineOn, d.errorCode});
+        }
+        return true;
+    });
+    result.parseSeconds = secondsSince(start);
+    result.records = records.size();
+    result.rejected = parser.errors().rejected();
+
+    auto transport = makeTransport(kind, TransportRole::Sender);
+    if (transport == nullptr) {
+        return false;
+    }
+    TimedTransport timed(*transport);
+    MessageBatcher batcher(timed, std::chrono::milliseconds(5), encoding);
+    start = Clock::now();
+    for (const WireRecord& record : records) {
+        if (!batcher.add(record)) {
+            return false;
+        }
+    }
+    if (!batcher.flush()) {
+        return false;
+    }
+    const double batchSeconds = secondsSince(start);
+    result.sendSeconds = toSeconds(timed.sendTime());
+    result.encodeSeconds = std::max(0.0, batchSeconds - result.sendSeconds);
+    result.messages = batcher.messagesSent();
+    result.bytesSent = batcher.bytesSent();
+    return transport->sendEndOfStream();
+}
+
+double rate(double count, double seconds) {
+    return seconds > 0 ? count / seconds : 0.0;
+}
+
+void printResult(TransportKind kind, BatchEncoding encoding, const SenderResult& s, const ReceiverResult& r) {
+    const double mb = s.fileBytes / 1e6;
+    std::printf(
+        "{\"transport\":\"%s\",\"encoding\":\"%s\",\"file_bytes\":%llu,\"lines\":%llu,\"records\":%llu,"
+        "\"rejected\":%llu,\"messages\":%llu,\"bytes_sent\":%llu,"
+        "\"read_mb_per_s\":%.1f,\"parse_mb_per_s\":%.1f,\"parse_records_per_s\":%.0f,"
+        "\"encode_records_per_s\":%.0f,\"send_records_per_s\":%.0f,\"send_msgs_per_s\":%.0f,"
+        "\"receive_records_per_s\":%.0f,\"decode_output_records_per_s\":%.0f,"
+        "\"latency_samples\":%llu,\"latency_p50_us\":%.1f,\"latency_p99_us\":%.1f,\"latency_max_us\":%.1f,"
+        "\"fault_latency_samples\":%llu,\"fault_latency_p50_us\":%.1f,\"fault_latency_p99_us\":%.1f,"
+        "\"fault_latency_max_us\":%.1f,\"complete\":%s}\n",
+        transportKindToString(kind), batchEncodingToString(encoding), static_cast<unsigned long long>(s.fileBytes),
+        static_cast<unsigned long long>(s.lines), static_cast<unsigned long long>(s.records),
+        static_cast<unsigned long long>(s.rejected), static_cast<unsigned long long>(s.messages),
+        static_cast<unsigned long long>(s.bytesSent), rate(mb, s.readSeconds), rate(mb, s.parseSeconds),
+        rate(s.records, s.parseSeconds), rate(s.records, s.encodeSeconds), rate(s.records, s.sendSeconds),
+        rate(s.messages, s.sendSeconds), rate(r.records, r.receiveSeconds), rate(r.records, r.decodeOutputSeconds),
+        static_cast<unsigned long long>(r.routineLatency.count), r.routineLatency.p50Us, r.routineLatency.p99Us,
+        r.routineLatency.maxUs, static_cast<unsigned long long>(r.faultLatency.count), r.faultLatency.p50Us,
+        r.faultLatency.p99Us, r.faultLatency.maxUs,
+        r.records == s.records && r.messages == s.messages ? "true" : "false");
+    std::fflush(stdout);
+}
+
+bool benchmark(TransportKind kind, BatchEncoding encoding, const OutputOptions& outputOptions,
+               const std::string& path) {
+    int readyPipe[2];
+    int resultPipe[2];
+    if (pipe(readyPipe) == -1 || pipe(resultPipe) == -1) {
+        perror("pipe");
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(readyPipe[0]);
+        close(resultPipe[0]);
+        ReceiverResult result = runReceiver(kind, outputOptions, readyPipe[1]);
+        bool written = write(resultPipe[1], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        _exit(result.ok && written ? 0 : 1);
+    }
+    close(readyPipe[1]);
+    close(resultPipe[1]);
+    char ready = 0;
+    SenderResult sent;
+    bool ok = read(readyPipe[0], &ready, 1) == 1 && runSender(kind, encoding, path, sent);
+    close(readyPipe[0]);
+    ReceiverResult received;
+    ok = read(resultPipe[0], &received, sizeof(received)) == static_cast<ssize_t>(sizeof(received)) && ok;
+    close(resultPipe[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "benchmark failed for " << transportKindToString(kind) << std::endl;
+        return false;
+    }
+    printResult(kind, encoding, sent, received);
+    return true;
+}
+
+constexpr const char* kUsage =
+    "Usage: pipelineBench [--records=N] [--malformed=RATIO] [--transport=<name>] [--encoding=fixed|delta]"
+    " [--format=human|csv|json] [file]";
+
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t records = 1000000;
+    double malformedRatio = 0.01;
+    std::string path;
+    TransportKind kind;
+    BatchEncoding encoding;
+    OutputOptions outputOptions;
+    if (!transportKindFromArgs(argc, argv, kind) || !batchEncodingFromArgs(argc, argv, encoding) ||
+        !outputOptionsFromArgs(argc, argv, outputOptions)) {
+        return 1;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool valid = true;
+        if (arg.rfind("--records=", 0) == 0) {
+            valid = parseNumber(arg.substr(10), records);
+        } else if (arg.rfind("--malformed=", 0) == 0) {
+            valid = parseNumber(arg.substr(12), malformedRatio) && malformedRatio >= 0.0 && malformedRatio <= 1.0;
+        } else if (arg.rfind("--", 0) != 0 && arg != "-q" && arg != "-v") {
+            path = std::string(arg);
+        }
+        if (!valid) {
+            std::cerr << "Invalid argument: " << arg << '\n' << kUsage << std::endl;
+            return 1;
+        }
+    }
+
+    bool generated = false;
+    if (path.empty()) {
+        char tmpl[] = "/tmp/pipelineBench.XXXXXX";
+        int fd = mkstemp(tmpl);
+        if (fd == -1) {
+            perror("mkstemp");
+            return 1;
+        }
+        close(fd);
+        path = tmpl;
+        generated = true;
+        if (!writeFeed(path, records, malformedRatio)) {
+            unlink(path.c_str());
+            return 1;
+        }
+    }
+    bool ok = benchmark(kind, encoding, outputOptions, path);
+    if (generated) {
+        unlink(path.c_str());
+    }
+    return ok ? 0 : 1;
+}
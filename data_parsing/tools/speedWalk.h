@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Synthetic speed traces for telemetryGen. A vehicle's speed at a given
+// second is a pure function of (seed, vehicle, second): smoothly
+// interpolated random offsets from its cruising speed on a 64 s and an 8 s
+// scale, plus a little per-second jitter. Any stretch of the feed can be
+// generated on its own and still continues every vehicle's trace exactly,
+// and consecutive seconds differ by a few km/h at most.
+class SpeedWalk {
+public:
+    static constexpr double kMaxSpeed = 220.0;
+
+    // The knots around one vehicle's current second, cached between calls
+    // for that vehicle. Only a cache: at() returns the same with a fresh one.
+    struct Knots {
+        uint64_t segment[2] = {UINT64_MAX, UINT64_MAX};
+        double start[2] = {};
+        double end[2] = {};
+    };
+
+    explicit SpeedWalk(uint64_t seed) : seed_(seed) {}
+
+    double cruise(uint32_t vehicle) const { return 40.0 + unit(hash(vehicle, 0, 0)) * 80.0; }
+
+    double at(uint32_t vehicle, double cruiseSpeed, uint64_t second) const {
+        Knots knots;
+        return at(vehicle, cruiseSpeed, second, knots);
+    }
+
+    double at(uint32_t vehicle, double cruiseSpeed, uint64_t second, Knots& knots) const {
+        double speed = cruiseSpeed + 20.0 * noise(vehicle, 0, second, knots) + 8.0 * noise(vehicle, 1, second, knots) +
+                       (unit(hash(vehicle, 3, second)) - 0.5);
+        return std::clamp(speed, 0.0, kMaxSpeed);
+    }
+
+private:
+    // splitmix64's finalizer over the packed inputs.
+    uint64_t hash(uint32_t vehicle, uint64_t stream, uint64_t index) const {
+        uint64_t z = seed_ ^ (static_cast<uint64_t>(vehicle) * 0x9e3779b97f4a7c15ULL) ^
+                     ((index * 4 + stream) * 0xd1b54a32d192ed03ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1).
+    static double unit(uint64_t bits) { return (bits >> 11) * (1.0 / (1ULL << 53)); }
+
+    double knot(uint32_t vehicle, size_t scale, uint64_t segment) const {
+        return unit(hash(vehicle, 1 + scale, segment)) * 2.0 - 1.0;
+    }
+
+    // In [-1, 1): random knots every 64 s (scale 0) or 8 s (scale 1),
+    // smoothstep in between.
+    double noise(uint32_t vehicle, size_t scale, uint64_t second, Knots& knots) const {
+        const unsigned shift = scale == 0 ? 6 : 3;
+        const uint64_t segment = second >> shift;
+        if (segment != knots.segment[scale]) {
+            const bool next = knots.segment[scale] != UINT64_MAX && segment == knots.segment[scale] + 1;
+            knots.start[scale] = next ? knots.end[scale] : knot(vehicle, scale, segment);
+            knots.end[scale] = knot(vehicle, scale, segment + 1);
+            knots.segment[scale] = segment;
+        }
+        const double t = static_cast<double>(second & ((1ULL << shift) - 1)) / static_cast<double>(1ULL << shift);
+        const double a = knots.start[scale];
+        return a + (knots.end[scale] - a) * (t * t * (3.0 - 2.0 * t));
+    }
+
+    uint64_t seed_;
+};
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include "speedWalk.h"
+
+namespace {
+
+constexpr uint64_t kChunkLines = 1 << 16;  // telemetryGen's chunk size
+
+// Lag-1 autocorrelation of one vehicle's trace over the given seconds.
+double lagOneCorrelation(const SpeedWalk& walk, uint32_t vehicle, uint64_t first, uint64_t seconds) {
+    const double cruise = walk.cruise(vehicle);
+    double sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
+    double previous = walk.at(vehicle, cruise, first);
+    for (uint64_t s = first + 1; s <= first + seconds; ++s) {
+        const double current = walk.at(vehicle, cruise, s);
+        sumX += previous;
+        sumY += current;
+        sumXX += previous * previous;
+        sumYY += current * current;
+        sumXY += previous * current;
+        previous = current;
+    }
+    const double n = static_cast<double>(seconds);
+    const double cov = sumXY / n - (sumX / n) * (sumY / n);
+    const double varX = sumXX / n - (sumX / n) * (sumX / n);
+    const double varY = sumYY / n - (sumY / n) * (sumY / n);
+    return cov / std::sqrt(varX * varY);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "[Test] starting speed walk tests\n";
+
+    // Test 1: the trace is a pure function of seed, vehicle and second.
+    {
+        const SpeedWalk a(42);
+        const SpeedWalk b(42);
+        const SpeedWalk other(43);
+        size_t differing = 0;
+        for (uint32_t v = 0; v < 1000; ++v) {
+            assert(a.cruise(v) >= 40.0 && a.cruise(v) < 120.0);
+            for (uint64_t s = 0; s < 50; ++s) {
+                const double speed = a.at(v, a.cruise(v), s);
+                assert(speed == b.at(v, b.cruise(v), s));
+                assert(speed >= 0.0 && speed <= SpeedWalk::kMaxSpeed);
+                differing += speed != other.at(v, other.cruise(v), s);
+            }
+        }
+        assert(differing > 49000);
+        // The knot cache gives the same trace, also when seconds are skipped
+        // or revisited.
+        SpeedWalk::Knots knots;
+        double uncached[1001];
+        for (uint64_t s = 0; s <= 1000; ++s) {
+            uncached[s] = a.at(3, a.cruise(3), s);
+        }
+        for (uint64_t s : {0, 1, 7, 8, 9, 63, 64, 65, 200, 130, 131, 1000, 0}) {
+            assert(a.at(3, a.cruise(3), s, knots) == uncached[s]);
+        }
+        SpeedWalk::Knots fresh;
+        assert(a.at(3, a.cruise(3), 0, fresh) == uncached[0]);
+        std::cout << "[Test1] deterministic trace ok\n";
+    }
+
+    // Test 2: a vehicle's consecutive samples stay close and correlated where
+    // they fall in different generator chunks, also for fleets of a chunk or more.
+    {
+        const SpeedWalk walk(1);
+        for (uint64_t vehicles : {1000ULL, 65536ULL, 70000ULL}) {
+            for (uint64_t chunk = 1; chunk <= 64; ++chunk) {
+                // Line chunk * kChunkLines opens a chunk; the same vehicle's
+                // previous sample is one fleet earlier, in an earlier chunk.
+                const uint64_t line = chunk * kChunkLines;
+                if (line < vehicles) {
+                    continue;
+                }
+                const uint32_t vehicle = static_cast<uint32_t>(line % vehicles);
+                const uint64_t second = line / vehicles;
+                assert((line - vehicles) / kChunkLines < chunk);
+                const double cruise = walk.cruise(vehicle);
+                assert(std::fabs(walk.at(vehicle, cruise, second) - walk.at(vehicle, cruise, second - 1)) < 6.0);
+                assert(lagOneCorrelation(walk, vehicle, second, 4096) > 0.95);
+            }
+        }
+        std::cout << "[Test2] traces continue across chunks ok\n";
+    }
+
+    std::cout << "\n[Test] all speed walk tests passed\n";
+    return 0;
+}
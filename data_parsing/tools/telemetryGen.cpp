@@ -0,0 +1,356 @@
+// telemetryGen: fast synthetic vehicle telemetry in the format parseLine() reads.
+//
+// Every vehicle in the fleet reports once per second, in id order, starting
+// at --start. Speeds wander smoothly around a per-vehicle cruising speed
+// (see speedWalk.h); engine and status fields use every spelling the parser
+// accepts (engine 1/ON/ENGINE_OK and 0/OFF; status ENGINE_OK/OK,
+// ENGINE_OVERHEAT, ENGINE_SENSOR_FAIL/SENSOR_FAILURE). Fault and malformed lines are injected at the given rates,
+// the malformed ones copied from the cases in vehicle_data.txt.
+//
+// Lines are generated in fixed-size chunks on a pool of threads and written
+// in order by the main thread. Each chunk is seeded from --seed and its index,
+// so output is identical for any thread count. Speeds depend only on the
+// vehicle and the second, so each trace runs on unbroken across chunks.
+//
+// Usage: telemetryGen [--records=N | --size=BYTES[k|m|g]] [--vehicles=N] [--first-id=N]
+//                     [--fault-rate=R] [--malformed=R] [--out-of-order=R]
+//                     [--start="YYYY-MM-DD HH:MM:SS"] [--threads=N] [--seed=N] [file|-]
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../common/orderedRun.h"
+#include "../common/timestamp.h"
+#include "speedWalk.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kChunkLines = 1 << 16;
+constexpr size_t kMaxLineBytes = 96;
+constexpr size_t kMaxBacksteps = 30;  // seconds an out-of-order record may go back
+
+struct Options {
+    uint64_t records = 1000000;
+    uint64_t sizeBytes = 0;  // non-zero: stop at this many bytes instead of a record count
+    uint32_t vehicles = 1000;
+    int64_t firstId = 1001;
+    double faultRate = 0.002;
+    double malformedRate = 0.0;
+    double outOfOrderRate = 0.0;
+    int64_t startNs = 1771064123LL * kNanosPerSecond;  // 2026-02-14 10:15:23
+    size_t threads = 0;
+    uint64_t seed = 1;
+    std::string path;
+};
+
+// splitmix64: tiny, fast and good enough for test data.
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    // Uniform in [0, 1).
+    double unit() { return (next() >> 11) * (1.0 / (1ULL << 53)); }
+
+private:
+    uint64_t state_;
+};
+
+char* appendInt(char* out, int64_t value) {
+    return std::to_chars(out, out + 24, value).ptr;
+}
+
+char* appendText(char* out, std::string_view text) {
+    std::memcpy(out, text.data(), text.size());
+    return out + text.size();
+}
+
+// Speed in tenths, e.g. 885 -> "88.5".
+char* appendTenths(char* out, int64_t tenths) {
+    out = appendInt(out, tenths / 10);
+    *out++ = '.';
+    *out++ = static_cast<char>('0' + tenths % 10);
+    return out;
+}
+
+class ChunkGenerator {
+public:
+    explicit ChunkGenerator(const Options& options)
+        : options_(options), walk_(options.seed), knots_(options.vehicles) {
+        cruise_.reserve(options.vehicles);
+        for (uint32_t v = 0; v < options.vehicles; ++v) {
+            cruise_.push_back(walk_.cruise(v));
+        }
+    }
+
+    // Fills out with lines [first, first + count) of the feed.
+    void generate(uint64_t chunkIndex, uint64_t first, size_t count, std::string& out) {
+        Rng rng(options_.seed ^ (chunkIndex * 0xd1b54a32d192ed03ULL));
+        out.resize(count * kMaxLineBytes);
+        char* p = out.data();
+        int64_t cachedSecond = -1;
+        char stamp[kTimestampTextLen + 1];
+        char oldStamp[kTimestampTextLen + 1];
+        for (uint64_t i = first; i < first + count; ++i) {
+            const uint32_t vehicle = static_cast<uint32_t>(i % options_.vehicles);
+            const int64_t second = static_cast<int64_t>(i / options_.vehicles);
+            if (second != cachedSecond) {
+                formatTimestamp(options_.startNs + second * kNanosPerSecond, stamp);
+                cachedSecond = second;
+            }
+            const char* ts = stamp;
+            if (options_.outOfOrderRate > 0 && rng.unit() < options_.outOfOrderRate) {
+                const int64_t back = 1 + static_cast<int64_t>(rng.next() % kMaxBacksteps);
+                formatTimestamp(options_.startNs + (second - back) * kNanosPerSecond, oldStamp);
+                ts = oldStamp;
+            }
+            const int64_t id = options_.firstId + vehicle;
+            if (options_.malformedRate > 0 && rng.unit() < options_.malformedRate) {
+                p = appendMalformed(p, rng, id, ts);
+                *p++ = '\n';
+                continue;
+            }
+
+            const double speed = walk_.at(vehicle, cruise_[vehicle], static_cast<uint64_t>(second), knots_[vehicle]);
+            const bool engineOn = rng.next() % 50 != 0;
+            const int64_t tenths = engineOn ? static_cast<int64_t>(speed * 10.0 + 0.5) : 0;
+
+            p = appendInt(p, id);
+            *p++ = ',';
+            p = appendText(p, std::string_view(ts, kTimestampTextLen));
+            *p++ = ',';
+            p = appendTenths(p, tenths);
+            *p++ = ',';
+            const uint64_t spelling = rng.next();
+            if (engineOn) {
+                p = appendText(p, spelling % 16 == 0 ? "ON" : spelling % 16 == 8 ? "ENGINE_OK" : "1");
+            } else {
+                p = appendText(p, spelling % 8 == 0 ? "OFF" : "0");
+            }
+            *p++ = ',';
+            p = appendText(p, statusText(rng, spelling >> 8));
+            *p++ = '\n';
+        }
+        out.resize(static_cast<size_t>(p - out.data()));
+    }
+
+private:
+    std::string_view statusText(Rng& rng, uint64_t spelling) const {
+        if (options_.faultRate > 0 && rng.unit() < options_.faultRate) {
+            if (spelling % 2 == 0) {
+                return "ENGINE_OVERHEAT";
+            }
+            return spelling % 4 == 1 ? "SENSOR_FAILURE" : "ENGINE_SENSOR_FAIL";
+        }
+        return spelling % 16 == 0 ? "OK" : "ENGINE_OK";
+    }
+
+    static char* appendMalformed(char* p, Rng& rng, int64_t id, const char* ts) {
+        const std::string_view stamp(ts, kTimestampTextLen);
+        switch (rng.next() % 5) {
+            case 0:  // too few fields
+                p = appendInt(p, id);
+                return appendText(p, ",INVALID_DATA");
+            case 1:  // bad speed
+                p = appendInt(p, id);
+                *p++ = ',';
+                p = appendText(p, stamp);
+                return appendText(p, ",abc,1,ENGINE_OK");
+            case 2:  // missing id
+                *p++ = ',';
+                p = appendText(p, stamp);
+                return appendText(p, ",77.3,1,ENGINE_OK");
+            case 3:  // bad engine flag
+                p = appendInt(p, id);
+                *p++ = ',';
+                p = appendText(p, stamp);
+                return appendText(p, ",98.2,2,ENGINE_OK");
+            default:  // too many fields
+                p = appendInt(p, id);
+                *p++ = ',';
+                p = appendText(p, stamp);
+                return appendText(p, ",98.2,1,ENGINE_OK,extra");
+        }
+    }
+
+    const Options& options_;
+    SpeedWalk walk_;
+    std::vector<double> cruise_;
+    std::vector<SpeedWalk::Knots> knots_;
+};
+
+bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Generates chunks on the worker threads and writes them to fd in order.
+bool run(const Options& options, int fd, uint64_t& linesWritten, uint64_t& bytesWritten) {
+    const uint64_t totalLines = options.sizeBytes != 0 ? UINT64_MAX : options.records;
+    const uint64_t chunkCount = options.sizeBytes != 0 ? UINT64_MAX : (totalLines + kChunkLines - 1) / kChunkLines;
+    const size_t threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const OrderedRunOptions runOptions{chunkCount, threads, threads * 2};
+
+    std::vector<ChunkGenerator> generators;
+    generators.reserve(orderedRunWorkers(runOptions));
+    for (size_t i = 0; i < orderedRunWorkers(runOptions); ++i) {
+        generators.emplace_back(options);
+    }
+    std::vector<std::string> slots(orderedRunWindow(runOptions));
+
+    bool ok = true;
+    runInOrder(
+        runOptions,
+        [&](size_t worker, uint64_t index, size_t slot) {
+            const uint64_t first = index * kChunkLines;
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(kChunkLines, totalLines - first));
+            generators[worker].generate(index, first, count, slots[slot]);
+        },
+        [&](uint64_t, size_t slot) {
+            std::string_view text = slots[slot];
+            bool last = false;
+            if (options.sizeBytes != 0 && bytesWritten + text.size() >= options.sizeBytes) {
+                // Cut at the last whole line that fits, but always end on at least one line.
+                size_t cut = text.rfind('\n', options.sizeBytes - bytesWritten - 1);
+                text = text.substr(0, cut == std::string_view::npos ? text.find('\n') + 1 : cut + 1);
+                last = true;
+            }
+            ok = writeAll(fd, text.data(), text.size());
+            bytesWritten += text.size();
+            linesWritten += static_cast<uint64_t>(std::count(text.begin(), text.end(), '\n'));
+            return ok && !last;
+        });
+    return ok;
+}
+
+bool parseCount(std::string_view text, uint64_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    std::string_view suffix = text.substr(static_cast<size_t>(result.ptr - text.data()));
+    if (result.ec != std::errc() || suffix.size() > 1) {
+        return false;
+    }
+    if (suffix.empty()) {
+        return true;
+    }
+    switch (suffix[0]) {
+        case 'k': case 'K': value <<= 10; return true;
+        case 'm': case 'M': value <<= 20; return true;
+        case 'g': case 'G': value <<= 30; return true;
+    }
+    return false;
+}
+
+bool parseRate(std::string_view text, double& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size() && value >= 0.0 && value <= 1.0;
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&](std::string_view prefix, std::string_view& out) {
+            if (arg.rfind(prefix, 0) != 0) {
+                return false;
+            }
+            out = arg.substr(prefix.size());
+            return true;
+        };
+        std::string_view v;
+        uint64_t n = 0;
+        bool ok = true;
+        if (value("--records=", v)) {
+            ok = parseCount(v, options.records);
+        } else if (value("--size=", v)) {
+            ok = parseCount(v, options.sizeBytes) && options.sizeBytes > 0;
+        } else if (value("--vehicles=", v)) {
+            ok = parseCount(v, n) && n > 0 && n <= UINT32_MAX;
+            options.vehicles = static_cast<uint32_t>(n);
+        } else if (value("--first-id=", v)) {
+            ok = parseCount(v, n) && n <= INT32_MAX;
+            options.firstId = static_cast<int64_t>(n);
+        } else if (value("--fault-rate=", v)) {
+            ok = parseRate(v, options.faultRate);
+        } else if (value("--malformed=", v)) {
+            ok = parseRate(v, options.malformedRate);
+        } else if (value("--out-of-order=", v)) {
+            ok = parseRate(v, options.outOfOrderRate);
+        } else if (value("--start=", v)) {
+            ok = parseTimestamp(v, options.startNs);
+        } else if (value("--threads=", v)) {
+            ok = parseCount(v, n);
+            options.threads = static_cast<size_t>(n);
+        } else if (value("--seed=", v)) {
+            ok = parseCount(v, options.seed);
+        } else if (arg.rfind("--", 0) == 0) {
+            ok = false;
+        } else {
+            options.path = std::string(arg);
+        }
+        if (!ok) {
+            std::cerr << "Invalid argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.firstId + options.vehicles - 1 > INT32_MAX) {
+        std::cerr << "Vehicle ids do not fit in 32 bits" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        return 1;
+    }
+    int fd = STDOUT_FILENO;
+    if (!options.path.empty() && options.path != "-") {
+        fd = open(options.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) {
+            perror("open");
+            return 1;
+        }
+    }
+
+    auto start = Clock::now();
+    uint64_t lines = 0;
+    uint64_t bytes = 0;
+    bool ok = run(options, fd, lines, bytes);
+    if (fd != STDOUT_FILENO && close(fd) == -1) {
+        perror("close");
+        ok = false;
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::fprintf(stderr, "lines: %llu, bytes: %llu, %.2f s, %.1f MB/s\n", static_cast<unsigned long long>(lines),
+                 static_cast<unsigned long long>(bytes), seconds, seconds > 0 ? bytes / seconds / 1e6 : 0.0);
+    return ok ? 0 : 1;
+}
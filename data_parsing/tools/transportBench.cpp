@@ -0,0 +1,204 @@
+// transportBench: compares the sender->receiver transports on this machine.
+//
+// For each transport a receiver child is forked and the parent acts as the
+// sender. Phase 1 sends messages back to back and reports throughput; phase 2
+// paces small messages and reports one-way latency percentiles, measured
+// from CLOCK_MONOTONIC timestamps embedded in each payload. One JSON object
+// is printed per transport.
+//
+// Usage: transportBench [--messages=N] [--size=BYTES] [--transport=<name>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../common/transport.h"
+#include "../common/vehicleWire.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kLatencyMessages = 2000;
+constexpr size_t kLatencyMessageBytes = 64;
+constexpr auto kLatencyPacing = std::chrono::microseconds(50);
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<int64_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index] / 1000.0;
+}
+
+// Receiver side: runs in the child, prints the JSON result line.
+int runReceiver(TransportKind kind, int readyFd, size_t messages, size_t messageBytes) {
+    auto transport = makeTransport(kind, TransportRole::Receiver);
+    if (transport == nullptr) {
+        return 1;
+    }
+    std::vector<unsigned char> buf(kMaxMsgPayload);
+    size_t len = 0;
+    // Drop anything a previous run left in a persistent queue.
+    RecvStatus status;
+    do {
+        status = transport->receive(buf.data(), buf.size(), len, std::chrono::milliseconds(0));
+    } while (status == RecvStatus::E_OK || status == RecvStatus::E_EndOfStream);
+    char ready = 1;
+    if (write(readyFd, &ready, 1) != 1) {
+        return 1;
+    }
+
+    // Phase 1: throughput.
+    size_t received = 0;
+    Clock::time_point first{};
+    Clock::time_point last{};
+    while (true) {
+        status = transport->receive(buf.data(), buf.size(), len, kWaitForever);
+        if (status == RecvStatus::E_EndOfStream) {
+            break;
+        }
+        if (status != RecvStatus::E_OK) {
+            return 1;
+        }
+        last = Clock::now();
+        if (received++ == 0) {
+            first = last;
+        }
+    }
+    double seconds = std::chrono::duration<double>(last - first).count();
+
+    // Phase 2: paced one-way latency.
+    std::vector<int64_t> latencies;
+    latencies.reserve(kLatencyMessages);
+    while (true) {
+        status = transport->receive(buf.data(), buf.size(), len, kWaitForever);
+        if (status == RecvStatus::E_EndOfStream) {
+            break;
+        }
+        if (status != RecvStatus::E_OK) {
+            return 1;
+        }
+        int64_t sentNs;
+        std::memcpy(&sentNs, buf.data(), sizeof(sentNs));
+        latencies.push_back(nowNs() - sentNs);
+    }
+
+    double msgsPerSec = seconds > 0 ? (received - 1) / seconds : 0.0;
+    std::printf("{\"transport\":\"%s\",\"messages\":%zu,\"message_bytes\":%zu,\"throughput_msgs_per_s\":%.0f,"
+                "\"throughput_mb_per_s\":%.1f,\"latency_samples\":%zu,\"latency_p50_us\":%.1f,"
+                "\"latency_p99_us\":%.1f,\"complete\":%s}\n",
+                transport->name(), received, messageBytes, msgsPerSec, msgsPerSec * messageBytes / 1e6,
+                latencies.size(), percentile(latencies, 0.50), percentile(latencies, 0.99),
+                received == messages && latencies.size() == kLatencyMessages ? "true" : "false");
+    std::fflush(stdout);
+    return 0;
+}
+
+bool runSender(TransportKind kind, size_t messages, size_t messageBytes) {
+    auto transport = makeTransport(kind, TransportRole::Sender);
+    if (transport == nullptr) {
+        return false;
+    }
+    size_t bytes = std::min(messageBytes, transport->maxMessageSize());
+    std::vector<unsigned char> payload(bytes, 0xab);
+    for (size_t i = 0; i < messages; ++i) {
+        if (!transport->send(payload.data(), payload.size())) {
+            return false;
+        }
+    }
+    if (!transport->sendEndOfStream()) {
+        return false;
+    }
+
+    payload.assign(kLatencyMessageBytes, 0);
+    auto next = Clock::now();
+    for (size_t i = 0; i < kLatencyMessages; ++i) {
+        // Sleep rather than spin so the receiver keeps its CPU on small machines.
+        next += kLatencyPacing;
+        std::this_thread::sleep_until(next);
+        int64_t sentNs = nowNs();
+        std::memcpy(payload.data(), &sentNs, sizeof(sentNs));
+        if (!transport->send(payload.data(), payload.size())) {
+            return false;
+        }
+    }
+    return transport->sendEndOfStream();
+}
+
+bool benchmark(TransportKind kind, size_t messages, size_t messageBytes) {
+    int readyPipe[2];
+    if (pipe(readyPipe) == -1) {
+        perror("pipe");
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(readyPipe[0]);
+        _exit(runReceiver(kind, readyPipe[1], messages, messageBytes));
+    }
+    close(readyPipe[1]);
+    char ready = 0;
+    bool ok = read(readyPipe[0], &ready, 1) == 1 && runSender(kind, messages, messageBytes);
+    close(readyPipe[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "benchmark failed for " << transportKindToString(kind) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t numericArg(std::string_view arg, std::string_view prefix, size_t fallback) {
+    if (arg.substr(0, prefix.size()) != prefix) {
+        return fallback;
+    }
+    return std::stoul(std::string(arg.substr(prefix.size())));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t messages = 200000;
+    size_t messageBytes = 1024;
+    bool onlyOne = false;
+    TransportKind only = TransportKind::SysVQueue;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        messages = numericArg(arg, "--messages=", messages);
+        messageBytes = std::max<size_t>(numericArg(arg, "--size=", messageBytes), sizeof(int64_t));
+        if (arg.substr(0, 12) == "--transport=") {
+            if (!parseTransportKind(arg.substr(12), only)) {
+                std::cerr << "Unknown transport: " << arg.substr(12) << std::endl;
+                return 1;
+            }
+            onlyOne = true;
+        }
+    }
+
+    bool allOk = true;
+    for (TransportKind kind : kAllTransportKinds) {
+        if (onlyOne && kind != only) {
+            continue;
+        }
+        allOk = benchmark(kind, messages, messageBytes) && allOk;
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// vehicleStats: offline summary of a telemetry file.
+//
+// Loads the file into a VehicleColumnStore once and answers from the columns:
+// record counts per status, a speed histogram and the max speed per vehicle.
+//
+// Usage: vehicleStats [--buckets=N] [--threads=N] [file]   (default vehicle_data.txt)
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "../parsing_&_sending/columnStore.h"
+#include "../parsing_&_sending/mappedFile.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* statusName(EngineStatus status) {
+    switch (status) {
+        case EngineStatus::OK: return "OK";
+        case EngineStatus::InvalidFormat: return "InvalidFormat";
+        case EngineStatus::E_SensorFailure: return "SensorFailure";
+        case EngineStatus::E_Overheat: return "Overheat";
+        case EngineStatus::E_Unknown: return "Unknown";
+    }
+    return "?";
+}
+
+bool parseSize(std::string_view text, size_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string path = DATA_FILE_PATH;
+    size_t buckets = 10;
+    size_t threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool ok = true;
+        if (arg.rfind("--buckets=", 0) == 0) {
+            ok = parseSize(arg.substr(10), buckets) && buckets > 0;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            ok = parseSize(arg.substr(10), threads);
+        } else if (arg.rfind("--", 0) == 0) {
+            ok = false;
+        } else {
+            path = std::string(arg);
+        }
+        if (!ok) {
+            std::cerr << "Invalid argument: " << arg << "\n"
+                      << "Usage: vehicleStats [--buckets=N] [--threads=N] [file]" << std::endl;
+            return 1;
+        }
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        return 1;
+    }
+    VehicleColumnStore store;
+    VehicleDataParser parser;
+    auto start = Clock::now();
+    auto loaded = store.load(file.view(), parser, threads);
+    double loadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::printf("records: %zu, rejected: %zu, load: %.1f ms, columns: %zu bytes (%zu as VehicleData)\n",
+                loaded.records, loaded.rejected, loadMs, store.memoryBytes(), store.size() * sizeof(VehicleData));
+    if (store.size() == 0) {
+        return 0;
+    }
+
+    for (EngineStatus status : {EngineStatus::OK, EngineStatus::E_SensorFailure, EngineStatus::E_Overheat,
+                                EngineStatus::E_Unknown}) {
+        std::printf("status %-14s %zu\n", statusName(status), store.countStatus(status));
+    }
+
+    double lo = store.speeds()[0];
+    double hi = lo;
+    for (double s : store.speeds()) {
+        lo = s < lo ? s : lo;
+        hi = s > hi ? s : hi;
+    }
+    if (hi == lo) {
+        hi = lo + 1.0;
+    }
+    auto hist = store.speedHistogram(lo, hi, buckets);
+    const double width = (hi - lo) / buckets;
+    for (size_t b = 0; b < hist.size(); ++b) {
+        std::printf("speed [%8.2f, %8.2f) %llu\n", lo + b * width, lo + (b + 1) * width,
+                    static_cast<unsigned long long>(hist[b]));
+    }
+
+    for (const auto& [id, best] : store.maxSpeedPerVehicle()) {
+        std::printf("vehicle %d max speed %.2f\n", id, best);
+    }
+    return 0;
+}